@@ -0,0 +1,517 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Stand-in for the telephony daemon: owns org.tizen.telephony on the
+ * system bus (point DBUS_SYSTEM_BUS_ADDRESS at a private dbus-daemon) and
+ * answers the Manager and Sim requests libtapi and libcapi-telephony-sim
+ * send, with fixed identity values per modem.
+ *
+ * org.tizen.telephony.Fake.SetStatus(i) on a modem path changes its SIM
+ * status and emits the Status signal, like a card being swapped, and
+ * Fake.Storm(i) emits a burst of Status signals.
+ *
+ * Faults are configured per method name, or for every method with "*"; a
+ * method keeps the "*" latency, drop and error it does not set itself:
+ *   --latency METHOD=fixed:MS | uniform:MIN:MAX | exp:MEAN
+ *   --drop METHOD=P            never reply, with probability P
+ *   --error METHOD=CODE:P      reply with TAPI_SIM_ACCESS_* CODE, probability P
+ *   --storm COUNT:PERIOD       every PERIOD ms, COUNT Status signals per modem
+ * --seed makes a run reproducible.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#define FAKE_SERVICE			"org.tizen.telephony"
+#define FAKE_MANAGER_PATH		"/org/tizen/telephony"
+#define FAKE_MANAGER_INTERFACE		"org.tizen.telephony.Manager"
+#define FAKE_SIM_INTERFACE		"org.tizen.telephony.Sim"
+#define FAKE_CONTROL_INTERFACE		"org.tizen.telephony.Fake"
+
+/* TelSimCardStatus_t / TelSimAccessResult_t values used here */
+#define FAKE_SIM_STATUS_INITIALIZING	0x02
+#define FAKE_SIM_STATUS_INIT_COMPLETED	0x03
+#define FAKE_SIM_ACCESS_SUCCESS		0x00
+#define FAKE_SIM_ACCESS_FILE_NOT_FOUND	0x02
+#define FAKE_SIM_ACCESS_ACCESS_CONDITION_NOT_SATISFIED	0x03
+
+typedef enum {
+	FAKE_DELAY_NONE,
+	FAKE_DELAY_FIXED,
+	FAKE_DELAY_UNIFORM,
+	FAKE_DELAY_EXP,
+} fake_delay_e;
+
+/* has_drop and has_error tell a probability set to 0 from one not set. */
+typedef struct fake_fault {
+	fake_delay_e delay;
+	double delay_a;
+	double delay_b;
+	gboolean has_drop;
+	double drop_p;
+	gboolean has_error;
+	int error_code;
+	double error_p;
+} fake_fault;
+
+typedef struct fake_reply {
+	GDBusMethodInvocation *invocation;
+	GVariant *reply;
+} fake_reply;
+
+typedef struct fake_modem {
+	int index;
+	char *name;
+	char *path;
+	int status;
+	gboolean card_changed;
+} fake_modem;
+
+static const gchar introspection_xml[] =
+	"<node>"
+	"  <interface name='" FAKE_MANAGER_INTERFACE "'>"
+	"    <method name='GetModems'><arg type='as' direction='out'/></method>"
+	"  </interface>"
+	"  <interface name='" FAKE_SIM_INTERFACE "'>"
+	"    <method name='GetInitStatus'>"
+	"      <arg type='i' direction='out'/><arg type='b' direction='out'/>"
+	"    </method>"
+	"    <method name='GetIMSI'>"
+	"      <arg type='i' direction='out'/><arg type='s' direction='out'/>"
+	"      <arg type='s' direction='out'/><arg type='s' direction='out'/>"
+	"    </method>"
+	"    <method name='GetICCID'>"
+	"      <arg type='i' direction='out'/><arg type='s' direction='out'/>"
+	"    </method>"
+	"    <method name='GetSpn'>"
+	"      <arg type='i' direction='out'/><arg type='y' direction='out'/><arg type='s' direction='out'/>"
+	"    </method>"
+	"    <method name='GetCphsNetName'>"
+	"      <arg type='i' direction='out'/><arg type='s' direction='out'/><arg type='s' direction='out'/>"
+	"    </method>"
+	"    <method name='GetMSISDN'>"
+	"      <arg type='i' direction='out'/><arg type='aa{sv}' direction='out'/>"
+	"    </method>"
+	"    <method name='AccessRSim'>"
+	"      <arg type='i' direction='in'/><arg type='i' direction='in'/><arg type='i' direction='in'/>"
+	"      <arg type='i' direction='in'/><arg type='i' direction='in'/><arg type='v' direction='in'/>"
+	"      <arg type='i' direction='out'/><arg type='i' direction='out'/><arg type='i' direction='out'/>"
+	"      <arg type='v' direction='out'/>"
+	"    </method>"
+	"    <signal name='Status'><arg type='i'/></signal>"
+	"  </interface>"
+	"  <interface name='" FAKE_CONTROL_INTERFACE "'>"
+	"    <method name='SetStatus'><arg type='i' direction='in'/></method>"
+	"    <method name='Storm'><arg type='i' direction='in'/></method>"
+	"  </interface>"
+	"</node>";
+
+static GDBusNodeInfo *introspection_data = NULL;
+static fake_modem *modems = NULL;
+static int modem_count = 1;
+static int msisdn_count = 2;
+static GDBusConnection *connection = NULL;
+static GHashTable *faults = NULL;
+static GRand *rng = NULL;
+static int storm_count = 0;
+static int storm_period = 0;
+
+static fake_fault *fault_get(const char *method, gboolean create)
+{
+	fake_fault *fault = g_hash_table_lookup(faults, method);
+
+	if (fault == NULL && create) {
+		fault = g_new0(fake_fault, 1);
+		g_hash_table_insert(faults, g_strdup(method), fault);
+	}
+	return fault;
+}
+
+/* The faults of @method over the "*" ones. */
+static void fault_for(const char *method, fake_fault *merged)
+{
+	fake_fault *all = fault_get("*", FALSE);
+	fake_fault *fault = fault_get(method, FALSE);
+
+	memset(merged, 0, sizeof(fake_fault));
+	if (all != NULL)
+		*merged = *all;
+	if (fault == NULL || fault == all)
+		return;
+	if (fault->delay != FAKE_DELAY_NONE) {
+		merged->delay = fault->delay;
+		merged->delay_a = fault->delay_a;
+		merged->delay_b = fault->delay_b;
+	}
+	if (fault->has_drop) {
+		merged->has_drop = TRUE;
+		merged->drop_p = fault->drop_p;
+	}
+	if (fault->has_error) {
+		merged->has_error = TRUE;
+		merged->error_code = fault->error_code;
+		merged->error_p = fault->error_p;
+	}
+}
+
+static gboolean parse_fault(const char *spec, const char *kind)
+{
+	gchar **parts = g_strsplit(spec, "=", 2);
+	fake_fault *fault = NULL;
+	gboolean ok = FALSE;
+	const char *arg = NULL;
+
+	if (parts[0] == NULL || parts[1] == NULL)
+		goto out;
+	fault = fault_get(parts[0], TRUE);
+	arg = parts[1];
+
+	if (!strcmp(kind, "latency")) {
+		if (sscanf(arg, "fixed:%lf", &fault->delay_a) == 1) {
+			fault->delay = FAKE_DELAY_FIXED;
+			ok = TRUE;
+		} else if (sscanf(arg, "uniform:%lf:%lf", &fault->delay_a, &fault->delay_b) == 2) {
+			fault->delay = FAKE_DELAY_UNIFORM;
+			ok = fault->delay_b >= fault->delay_a;
+		} else if (sscanf(arg, "exp:%lf", &fault->delay_a) == 1) {
+			fault->delay = FAKE_DELAY_EXP;
+			ok = TRUE;
+		}
+	} else if (!strcmp(kind, "drop")) {
+		ok = fault->has_drop = sscanf(arg, "%lf", &fault->drop_p) == 1;
+	} else if (!strcmp(kind, "error")) {
+		ok = fault->has_error = sscanf(arg, "%i:%lf", &fault->error_code, &fault->error_p) == 2;
+	}
+
+out:
+	if (!ok)
+		fprintf(stderr, "fake-telephony: invalid --%s '%s'\n", kind, spec);
+	g_strfreev(parts);
+	return ok;
+}
+
+static guint fault_delay_ms(const fake_fault *fault)
+{
+	double ms = 0;
+
+	switch (fault->delay) {
+		case FAKE_DELAY_FIXED:
+			ms = fault->delay_a;
+			break;
+		case FAKE_DELAY_UNIFORM:
+			ms = g_rand_double_range(rng, fault->delay_a, fault->delay_b);
+			break;
+		case FAKE_DELAY_EXP:
+			ms = -fault->delay_a * log(1.0 - g_rand_double(rng));
+			break;
+		default:
+			break;
+	}
+	return ms > 0 ? (guint) (ms + 0.5) : 0;
+}
+
+static void emit_status(GDBusConnection *conn, fake_modem *modem)
+{
+	g_dbus_connection_emit_signal(conn, NULL, modem->path, FAKE_SIM_INTERFACE, "Status",
+			g_variant_new("(i)", modem->status), NULL);
+}
+
+static GVariant *make_msisdn_reply(fake_modem *modem, int access_rt)
+{
+	GVariantBuilder builder;
+	gchar *number = NULL;
+	gchar *name = NULL;
+	int i = 0;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("aa{sv}"));
+	for (i = 0; access_rt == FAKE_SIM_ACCESS_SUCCESS && i < msisdn_count; i++) {
+		number = g_strdup_printf("+8210%04d%04d", modem->index, 1000 + i);
+		name = g_strdup_printf("Line %d", i + 1);
+		g_variant_builder_open(&builder, G_VARIANT_TYPE("a{sv}"));
+		g_variant_builder_add(&builder, "{sv}", "name", g_variant_new_string(name));
+		g_variant_builder_add(&builder, "{sv}", "number", g_variant_new_string(number));
+		g_variant_builder_close(&builder);
+		g_free(number);
+		g_free(name);
+	}
+	return g_variant_new("(iaa{sv})", access_rt, &builder);
+}
+
+/* The content of every file is its identifier, the record and the modem
+ * index, so that sim_read_files() results can be told apart. An injected
+ * error is answered with the status words a card would use for it. */
+static GVariant *make_rsim_reply(fake_modem *modem, GVariant *parameters, int access_rt)
+{
+	guchar content[4];
+	int cmd = 0;
+	int file_id = 0;
+	int p1 = 0;
+	int sw1 = 0x90;
+	int sw2 = 0x00;
+
+	g_variant_get(parameters, "(iiiiiv)", &cmd, &file_id, &p1, NULL, NULL, NULL);
+	content[0] = (file_id >> 8) & 0xff;
+	content[1] = file_id & 0xff;
+	content[2] = p1;
+	content[3] = modem->index;
+	if (access_rt == FAKE_SIM_ACCESS_FILE_NOT_FOUND) {
+		sw1 = 0x6A;
+		sw2 = 0x82;
+	} else if (access_rt == FAKE_SIM_ACCESS_ACCESS_CONDITION_NOT_SATISFIED) {
+		sw1 = 0x69;
+		sw2 = 0x82;
+	} else if (access_rt != FAKE_SIM_ACCESS_SUCCESS) {
+		sw1 = 0x6F;
+	}
+	return g_variant_new("(iiiv)", access_rt, sw1, sw2, g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, content,
+			access_rt == FAKE_SIM_ACCESS_SUCCESS ? sizeof(content) : 0, 1));
+}
+
+static GVariant *make_sim_reply(fake_modem *modem, const gchar *method, GVariant *parameters, int access_rt)
+{
+	gboolean ok = access_rt == FAKE_SIM_ACCESS_SUCCESS;
+	gchar *str = NULL;
+	GVariant *reply = NULL;
+
+	if (!g_strcmp0(method, "GetInitStatus"))
+		return g_variant_new("(ib)", modem->status, modem->card_changed);
+	if (!g_strcmp0(method, "GetIMSI")) {
+		str = g_strdup_printf("%010d", 123456789 + modem->index);
+		reply = g_variant_new("(isss)", access_rt, ok ? "450" : "", ok ? "05" : "", ok ? str : "");
+	} else if (!g_strcmp0(method, "GetICCID")) {
+		str = g_strdup_printf("898205%014d", 1000 + modem->index);
+		reply = g_variant_new("(is)", access_rt, ok ? str : "");
+	} else if (!g_strcmp0(method, "GetSpn")) {
+		str = g_strdup_printf("Fake Telecom %d", modem->index);
+		reply = g_variant_new("(iys)", access_rt, 0, ok ? str : "");
+	} else if (!g_strcmp0(method, "GetCphsNetName")) {
+		reply = g_variant_new("(iss)", access_rt, ok ? "Fake Telecom Network" : "", ok ? "FakeTel" : "");
+	} else if (!g_strcmp0(method, "GetMSISDN")) {
+		reply = make_msisdn_reply(modem, access_rt);
+	} else if (!g_strcmp0(method, "AccessRSim")) {
+		reply = make_rsim_reply(modem, parameters, access_rt);
+	}
+	g_free(str);
+	return reply;
+}
+
+static gboolean send_delayed_reply(gpointer user_data)
+{
+	fake_reply *delayed = user_data;
+
+	g_dbus_method_invocation_return_value(delayed->invocation, delayed->reply);
+	g_free(delayed);
+	return FALSE;
+}
+
+static void send_reply(GDBusMethodInvocation *invocation, GVariant *reply, const fake_fault *fault)
+{
+	fake_reply *delayed = NULL;
+	guint delay = fault_delay_ms(fault);
+
+	if (delay == 0) {
+		g_dbus_method_invocation_return_value(invocation, reply);
+		return;
+	}
+	delayed = g_new0(fake_reply, 1);
+	delayed->invocation = invocation;
+	delayed->reply = reply;
+	g_timeout_add(delay, send_delayed_reply, delayed);
+}
+
+static void emit_storm(int count)
+{
+	int i = 0;
+	int j = 0;
+	int status = 0;
+
+	for (i = 0; i < modem_count; i++) {
+		status = modems[i].status;
+		for (j = 0; j < count; j++) {
+			/* alternate, and end on the status the modem had */
+			modems[i].status = (count - j) % 2 ? status : FAKE_SIM_STATUS_INITIALIZING;
+			emit_status(connection, &modems[i]);
+		}
+		modems[i].status = status;
+	}
+}
+
+static gboolean on_storm_timer(gpointer user_data)
+{
+	emit_storm(storm_count);
+	return TRUE;
+}
+
+static void handle_method_call(GDBusConnection *conn, const gchar *sender, const gchar *object_path,
+		const gchar *interface_name, const gchar *method_name, GVariant *parameters,
+		GDBusMethodInvocation *invocation, gpointer user_data)
+{
+	fake_modem *modem = user_data;
+	fake_fault fault;
+	GVariantBuilder builder;
+	GVariant *reply = NULL;
+	int access_rt = FAKE_SIM_ACCESS_SUCCESS;
+	int value = 0;
+	int i = 0;
+
+	if (!g_strcmp0(interface_name, FAKE_CONTROL_INTERFACE)) {
+		g_variant_get(parameters, "(i)", &value);
+		if (!g_strcmp0(method_name, "Storm")) {
+			emit_storm(value);
+		} else {
+			modem->status = value;
+			modem->card_changed = TRUE;
+			emit_status(conn, modem);
+		}
+		g_dbus_method_invocation_return_value(invocation, NULL);
+		return;
+	}
+
+	fault_for(method_name, &fault);
+	if (fault.drop_p > 0 && g_rand_double(rng) < fault.drop_p) {
+		g_object_unref(invocation);
+		return;
+	}
+	if (fault.error_p > 0 && g_rand_double(rng) < fault.error_p)
+		access_rt = fault.error_code;
+
+	if (!g_strcmp0(interface_name, FAKE_MANAGER_INTERFACE)) {
+		g_variant_builder_init(&builder, G_VARIANT_TYPE("as"));
+		for (i = 0; i < modem_count; i++)
+			g_variant_builder_add(&builder, "s", modems[i].name);
+		send_reply(invocation, g_variant_new("(as)", &builder), &fault);
+		return;
+	}
+
+	reply = make_sim_reply(modem, method_name, parameters, access_rt);
+	if (reply == NULL) {
+		g_dbus_method_invocation_return_dbus_error(invocation, "org.freedesktop.DBus.Error.UnknownMethod",
+				method_name);
+		return;
+	}
+	send_reply(invocation, reply, &fault);
+}
+
+static const GDBusInterfaceVTable interface_vtable = {
+	handle_method_call,
+	NULL,
+	NULL,
+};
+
+static void on_bus_acquired(GDBusConnection *conn, const gchar *name, gpointer user_data)
+{
+	int i = 0;
+
+	connection = conn;
+	g_dbus_connection_register_object(conn, FAKE_MANAGER_PATH, introspection_data->interfaces[0],
+			&interface_vtable, NULL, NULL, NULL);
+	for (i = 0; i < modem_count; i++) {
+		g_dbus_connection_register_object(conn, modems[i].path, introspection_data->interfaces[1],
+				&interface_vtable, &modems[i], NULL, NULL);
+		g_dbus_connection_register_object(conn, modems[i].path, introspection_data->interfaces[2],
+				&interface_vtable, &modems[i], NULL, NULL);
+	}
+}
+
+static void on_name_acquired(GDBusConnection *conn, const gchar *name, gpointer user_data)
+{
+	printf("READY\n");
+	fflush(stdout);
+}
+
+static void on_name_lost(GDBusConnection *conn, const gchar *name, gpointer user_data)
+{
+	fprintf(stderr, "fake-telephony: cannot own %s\n", name);
+	exit(1);
+}
+
+static gboolean parse_faults(gchar **specs, const char *kind)
+{
+	int i = 0;
+
+	for (i = 0; specs != NULL && specs[i] != NULL; i++) {
+		if (!parse_fault(specs[i], kind))
+			return FALSE;
+	}
+	return TRUE;
+}
+
+int main(int argc, char **argv)
+{
+	gchar **latency_specs = NULL;
+	gchar **drop_specs = NULL;
+	gchar **error_specs = NULL;
+	gchar *storm_spec = NULL;
+	gint seed = 1;
+	GOptionEntry entries[] = {
+		{ "modems", 'm', 0, G_OPTION_ARG_INT, &modem_count, "Number of modems (SIM slots)", "N" },
+		{ "msisdn", 'n', 0, G_OPTION_ARG_INT, &msisdn_count, "Number of MSISDN entries per card", "N" },
+		{ "latency", 'l', 0, G_OPTION_ARG_STRING_ARRAY, &latency_specs, "Reply latency distribution", "METHOD=DIST" },
+		{ "drop", 'd', 0, G_OPTION_ARG_STRING_ARRAY, &drop_specs, "Probability of never replying", "METHOD=P" },
+		{ "error", 'e', 0, G_OPTION_ARG_STRING_ARRAY, &error_specs, "Access error injection", "METHOD=CODE:P" },
+		{ "storm", 's', 0, G_OPTION_ARG_STRING, &storm_spec, "Periodic Status signal bursts", "COUNT:PERIOD" },
+		{ "seed", 0, 0, G_OPTION_ARG_INT, &seed, "Random seed", "N" },
+		{ NULL }
+	};
+	GOptionContext *option_context = NULL;
+	GError *error = NULL;
+	GMainLoop *loop = NULL;
+	int i = 0;
+
+	option_context = g_option_context_new("- stand-in telephony service for sim-bench");
+	g_option_context_add_main_entries(option_context, entries, NULL);
+	if (!g_option_context_parse(option_context, &argc, &argv, &error) || modem_count < 1) {
+		fprintf(stderr, "fake-telephony: %s\n", error != NULL ? error->message : "invalid modem count");
+		return 1;
+	}
+	g_option_context_free(option_context);
+
+	rng = g_rand_new_with_seed(seed);
+	faults = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	if (!parse_faults(latency_specs, "latency") || !parse_faults(drop_specs, "drop")
+			|| !parse_faults(error_specs, "error"))
+		return 1;
+	if (storm_spec != NULL && (sscanf(storm_spec, "%d:%d", &storm_count, &storm_period) != 2
+			|| storm_count < 1 || storm_period < 1)) {
+		fprintf(stderr, "fake-telephony: invalid --storm '%s'\n", storm_spec);
+		return 1;
+	}
+
+	modems = g_new0(fake_modem, modem_count);
+	for (i = 0; i < modem_count; i++) {
+		modems[i].index = i;
+		modems[i].name = g_strdup_printf("fakemodem%d", i);
+		modems[i].path = g_strdup_printf("%s/%s", FAKE_MANAGER_PATH, modems[i].name);
+		modems[i].status = FAKE_SIM_STATUS_INIT_COMPLETED;
+	}
+
+	introspection_data = g_dbus_node_info_new_for_xml(introspection_xml, NULL);
+	g_bus_own_name(G_BUS_TYPE_SYSTEM, FAKE_SERVICE, G_BUS_NAME_OWNER_FLAGS_NONE, on_bus_acquired,
+			on_name_acquired, on_name_lost, NULL, NULL);
+
+	if (storm_period > 0)
+		g_timeout_add(storm_period, on_storm_timer, NULL);
+
+	loop = g_main_loop_new(NULL, FALSE);
+	g_main_loop_run(loop);
+	return 0;
+}
@@ -0,0 +1,60 @@
+#!/bin/sh
+#
+# Runs sim-bench against fake-telephony on a private dbus-daemon, so the
+# numbers do not depend on a modem or on the system telephony daemon.
+#
+#   run-bench.sh [sim-bench options]
+#
+# FAKE_TELEPHONY_ARGS is passed to fake-telephony, e.g. a tail-latency soak:
+#
+#   FAKE_TELEPHONY_ARGS="--latency *=exp:5 --drop GetICCID=0.001 --storm 20:5000" \
+#   run-bench.sh --soak 300 --threads 8
+#
+# and a throughput scaling run with the cache in use:
+#
+#   FAKE_TELEPHONY_ARGS="--latency *=fixed:1" run-bench.sh --scaling --watch
+#
+# and whether prefetched values survive status bursts: each burst drops the
+# cache once and prefetch reads it again, so with --stats dbus:GetICCID and
+# the like stay near one per burst instead of one per call (--stats needs a
+# library configured with -DENABLE_STATS=ON):
+#
+#   FAKE_TELEPHONY_ARGS="--storm 20:2000" run-bench.sh --prefetch --soak 60 --stats
+#
+# SIM_BENCH selects another benchmark binary. sim-bench-baseline only calls
+# the API of the first release, so for a before/after comparison run it
+# twice, once with LD_LIBRARY_PATH pointing at a build of the library from
+# before the change. Build the current library with ENABLE_STATS and
+# ENABLE_TRACE off, their default, so that it carries no instrumentation
+# the old one does not:
+#
+#   SIM_BENCH=./sim-bench-baseline LD_LIBRARY_PATH=/path/to/old/build run-bench.sh
+#   SIM_BENCH=./sim-bench-baseline run-bench.sh
+
+BENCH_DIR=$(cd "$(dirname "$0")" && pwd)
+WORK_DIR=$(mktemp -d)
+
+cleanup()
+{
+	[ -n "$FAKE_PID" ] && kill "$FAKE_PID" 2>/dev/null
+	[ -n "$BUS_PID" ] && kill "$BUS_PID" 2>/dev/null
+	rm -rf "$WORK_DIR"
+}
+trap cleanup EXIT INT TERM
+
+dbus-daemon --session --fork --print-address=3 --print-pid=4 \
+	3>"$WORK_DIR/address" 4>"$WORK_DIR/pid" || exit 1
+BUS_PID=$(cat "$WORK_DIR/pid")
+DBUS_SYSTEM_BUS_ADDRESS=$(head -n 1 "$WORK_DIR/address")
+export DBUS_SYSTEM_BUS_ADDRESS
+
+mkfifo "$WORK_DIR/ready"
+"$BENCH_DIR/fake-telephony" $FAKE_TELEPHONY_ARGS >"$WORK_DIR/ready" &
+FAKE_PID=$!
+read -r line <"$WORK_DIR/ready"
+if [ "$line" != "READY" ]; then
+	echo "run-bench.sh: fake-telephony did not start" >&2
+	exit 1
+fi
+
+"${SIM_BENCH:-$BENCH_DIR/sim-bench}" "$@"
@@ -0,0 +1,718 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Latency and throughput benchmark for the public getters of
+ * libcapi-telephony-sim. Meant to run against fake-telephony on a private
+ * bus (see run-bench.sh), so results do not depend on a modem.
+ *
+ * Every case runs in one or more worker threads, each with its own
+ * thread-default GMainContext so the _async getters complete on the thread
+ * that issued them. With --watch a state listener is registered first, which
+ * lets the library trust its cache and state mirror.
+ *
+ * --soak SECONDS instead keeps the selected cases running in random order on
+ * every thread and prints, once per --interval, the calls, errors and
+ * p50/p99/max latency seen in that window. Against fake-telephony with
+ * injected faults this shows tail latency and how long the library takes to
+ * recover after the faults stop.
+ *
+ * --prefetch enables sim_enable_prefetch() first; with --warmup 0 and
+ * --iterations 1 the numbers are those of the first read after start-up. With
+ * --soak against fake-telephony --storm it shows that the cache is refilled
+ * after every burst of Status signals.
+ *
+ * --optimistic enables sim_set_optimistic_mode(), so that each uncached getter
+ * sends one request instead of two.
+ *
+ * --dispatch-worker makes the --watch listener dispatched by the library's
+ * worker thread; --stats then shows the signal to callback latency of either
+ * mode as dispatch:Status.
+ *
+ * --scaling runs each case on 1, 2, 4, ... threads up to twice the number of
+ * processors and adds the speedup over one thread, to show whether
+ * concurrent callers serialize inside the library.
+ *
+ * Built with SIM_BENCH_BASELINE (the sim-bench-baseline target), only the
+ * getters and the state callback of the first release are used, so the same
+ * binary also runs against a library built from before the changes it is
+ * meant to measure; see run-bench.sh.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <glib.h>
+#include <sim.h>
+
+typedef int (*bench_fn)(void);
+
+typedef struct {
+	const char *name;
+	bench_fn fn;
+} bench_case;
+
+typedef struct {
+	bench_fn fn;
+	int iterations;
+	guint64 *samples;
+	guint64 start_ns;
+	guint64 end_ns;
+	int errors;
+} bench_worker;
+
+typedef struct {
+	gboolean done;
+	int error;
+} bench_wait;
+
+typedef struct {
+	int index;
+	GMutex lock;
+	GArray *window;
+	int window_errors;
+	GHashTable *errors;
+} soak_worker;
+
+static int opt_iterations = 1000;
+static int opt_warmup = 50;
+static gchar *opt_threads = NULL;
+static gchar *opt_filter = NULL;
+static gboolean opt_watch = FALSE;
+static int opt_soak = 0;
+static int opt_interval = 1000;
+static int opt_seed = 1;
+static gboolean opt_scaling = FALSE;
+#ifndef SIM_BENCH_BASELINE
+static gboolean opt_stats = FALSE;
+static int opt_timeout = SIM_TIMEOUT_DEFAULT;
+static gboolean opt_prefetch = FALSE;
+static gboolean opt_optimistic = FALSE;
+static gboolean opt_dispatch_worker = FALSE;
+#endif
+static volatile gint soak_running = 0;
+
+static guint64 now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (guint64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define BENCH_STRING_GETTER(name) \
+	static int bench_##name(void) \
+	{ \
+		char *value = NULL; \
+		int ret = name(&value); \
+		free(value); \
+		return ret; \
+	}
+
+BENCH_STRING_GETTER(sim_get_icc_id)
+BENCH_STRING_GETTER(sim_get_mcc)
+BENCH_STRING_GETTER(sim_get_mnc)
+BENCH_STRING_GETTER(sim_get_msin)
+BENCH_STRING_GETTER(sim_get_spn)
+BENCH_STRING_GETTER(sim_get_subscriber_number)
+
+static int bench_sim_get_cphs_operator_name(void)
+{
+	char *full_name = NULL;
+	char *short_name = NULL;
+	int ret = sim_get_cphs_operator_name(&full_name, &short_name);
+
+	free(full_name);
+	free(short_name);
+	return ret;
+}
+
+static int bench_sim_get_state(void)
+{
+	sim_state_e state;
+
+	return sim_get_state(&state);
+}
+
+#ifndef SIM_BENCH_BASELINE
+static int bench_wait_for(bench_wait *wait)
+{
+	GMainContext *context = g_main_context_get_thread_default();
+
+	while (!wait->done)
+		g_main_context_iteration(context, TRUE);
+	return wait->error;
+}
+
+static void on_string(sim_error_e error, const char *value, void *user_data)
+{
+	bench_wait *wait = user_data;
+
+	wait->error = error;
+	wait->done = TRUE;
+}
+
+static void on_imsi_info(sim_error_e error, const sim_imsi_info_s *imsi_info, void *user_data)
+{
+	on_string(error, NULL, user_data);
+}
+
+static void on_cphs(sim_error_e error, const char *full_name, const char *short_name, void *user_data)
+{
+	on_string(error, NULL, user_data);
+}
+
+#define BENCH_STRING_GETTER_R(name) \
+	static int bench_##name##_r(void) \
+	{ \
+		char value[64]; \
+		return name##_r(value, sizeof(value)); \
+	}
+
+BENCH_STRING_GETTER_R(sim_get_icc_id)
+BENCH_STRING_GETTER_R(sim_get_mcc)
+BENCH_STRING_GETTER_R(sim_get_mnc)
+BENCH_STRING_GETTER_R(sim_get_msin)
+BENCH_STRING_GETTER_R(sim_get_spn)
+BENCH_STRING_GETTER_R(sim_get_subscriber_number)
+
+#define BENCH_ASYNC_GETTER(name, cb) \
+	static int bench_##name(void) \
+	{ \
+		bench_wait wait = { FALSE, 0 }; \
+		int ret = name(cb, &wait); \
+		return ret == SIM_ERROR_NONE ? bench_wait_for(&wait) : ret; \
+	}
+
+BENCH_ASYNC_GETTER(sim_get_icc_id_async, on_string)
+BENCH_ASYNC_GETTER(sim_get_imsi_info_async, on_imsi_info)
+BENCH_ASYNC_GETTER(sim_get_spn_async, on_string)
+BENCH_ASYNC_GETTER(sim_get_cphs_operator_name_async, on_cphs)
+BENCH_ASYNC_GETTER(sim_get_subscriber_number_async, on_string)
+
+static int bench_sim_get_imsi_info(void)
+{
+	sim_imsi_info_s imsi_info;
+
+	return sim_get_imsi_info(&imsi_info);
+}
+
+static int bench_sim_get_cphs_operator_name_r(void)
+{
+	char full_name[64];
+	char short_name[64];
+
+	return sim_get_cphs_operator_name_r(full_name, sizeof(full_name), short_name, sizeof(short_name));
+}
+
+static int bench_sim_get_msisdn_list(void)
+{
+	sim_msisdn_list_h list = NULL;
+	const char *number = NULL;
+	int count = 0;
+	int ret = sim_get_msisdn_list(&list);
+
+	if (ret != SIM_ERROR_NONE)
+		return ret;
+	sim_msisdn_list_get_count(list, &count);
+	if (count > 0)
+		sim_msisdn_list_get_at(list, 0, &number, NULL);
+	sim_msisdn_list_destroy(list);
+	return ret;
+}
+
+static int bench_sim_get_snapshot(void)
+{
+	sim_snapshot_s snapshot;
+	int ret = sim_get_snapshot(&snapshot);
+
+	if (ret == SIM_ERROR_NONE)
+		sim_release_snapshot(&snapshot);
+	return ret;
+}
+
+static int bench_sim_get_all_snapshots(void)
+{
+	sim_snapshot_s snapshots[4];
+	int count = 0;
+	int i = 0;
+	int ret = sim_get_all_snapshots(snapshots, G_N_ELEMENTS(snapshots), &count);
+
+	for (i = 0; i < count; i++)
+		sim_release_snapshot(&snapshots[i]);
+	return ret;
+}
+
+/* EF_AD, EF_SPDI and the first records of EF_OPL and EF_PNN */
+static int bench_sim_read_files(void)
+{
+	static const sim_file_s files[] = {
+		{ 0x6FAD, 0 }, { 0x6FCD, 0 }, { 0x6FC6, 1 }, { 0x6FC5, 1 },
+	};
+	sim_file_result_s results[G_N_ELEMENTS(files)];
+	unsigned char buffer[1024];
+
+	return sim_read_files(files, G_N_ELEMENTS(files), buffer, sizeof(buffer), results);
+}
+
+static int bench_sim_get_home_operator_info(void)
+{
+	sim_home_operator_info_s info;
+
+	return sim_get_home_operator_info(&info);
+}
+
+static int bench_sim_lookup_operator(void)
+{
+	const char *country = NULL;
+	const char *name = NULL;
+
+	return sim_lookup_operator("450", "05", &country, &name);
+}
+#endif
+
+#define BENCH_CASE(name) { #name, bench_##name }
+
+/* The cases of the first release come first, in the same order in both
+ * builds, so that the two outputs line up. */
+static const bench_case cases[] = {
+	BENCH_CASE(sim_get_state),
+	BENCH_CASE(sim_get_icc_id),
+	BENCH_CASE(sim_get_mcc),
+	BENCH_CASE(sim_get_mnc),
+	BENCH_CASE(sim_get_msin),
+	BENCH_CASE(sim_get_spn),
+	BENCH_CASE(sim_get_cphs_operator_name),
+	BENCH_CASE(sim_get_subscriber_number),
+#ifndef SIM_BENCH_BASELINE
+	BENCH_CASE(sim_get_icc_id_r),
+	BENCH_CASE(sim_get_icc_id_async),
+	BENCH_CASE(sim_get_mcc_r),
+	BENCH_CASE(sim_get_mnc_r),
+	BENCH_CASE(sim_get_msin_r),
+	BENCH_CASE(sim_get_imsi_info),
+	BENCH_CASE(sim_get_imsi_info_async),
+	BENCH_CASE(sim_get_spn_r),
+	BENCH_CASE(sim_get_spn_async),
+	BENCH_CASE(sim_get_cphs_operator_name_r),
+	BENCH_CASE(sim_get_cphs_operator_name_async),
+	BENCH_CASE(sim_get_subscriber_number_r),
+	BENCH_CASE(sim_get_subscriber_number_async),
+	BENCH_CASE(sim_get_msisdn_list),
+	BENCH_CASE(sim_get_snapshot),
+	BENCH_CASE(sim_get_all_snapshots),
+	BENCH_CASE(sim_read_files),
+	BENCH_CASE(sim_get_home_operator_info),
+	BENCH_CASE(sim_lookup_operator),
+#endif
+};
+
+static gpointer bench_worker_run(gpointer user_data)
+{
+	bench_worker *worker = user_data;
+	GMainContext *context = g_main_context_new();
+	guint64 begin = 0;
+	int i = 0;
+
+	g_main_context_push_thread_default(context);
+
+	for (i = 0; i < opt_warmup; i++)
+		worker->fn();
+
+	worker->start_ns = now_ns();
+	for (i = 0; i < worker->iterations; i++) {
+		begin = now_ns();
+		if (worker->fn() != SIM_ERROR_NONE)
+			worker->errors++;
+		worker->samples[i] = now_ns() - begin;
+	}
+	worker->end_ns = now_ns();
+
+	g_main_context_pop_thread_default(context);
+	g_main_context_unref(context);
+	return NULL;
+}
+
+static int compare_samples(const void *a, const void *b)
+{
+	guint64 x = *(const guint64*) a;
+	guint64 y = *(const guint64*) b;
+
+	return x < y ? -1 : x > y;
+}
+
+static double percentile_us(const guint64 *sorted, int count, double p)
+{
+	int index = (int) (p * (count - 1) + 0.5);
+
+	return sorted[index] / 1000.0;
+}
+
+/* Returns the calls per second; with @base_rate > 0 the speedup over it is
+ * printed too. */
+static double bench_run(const bench_case *bc, int thread_count, double base_rate)
+{
+	bench_worker *workers = g_new0(bench_worker, thread_count);
+	GThread **threads = g_new0(GThread*, thread_count);
+	int total = opt_iterations * thread_count;
+	guint64 *samples = g_new(guint64, total);
+	guint64 start_ns = G_MAXUINT64;
+	guint64 end_ns = 0;
+	int errors = 0;
+	double rate = 0;
+	int i = 0;
+
+	for (i = 0; i < thread_count; i++) {
+		workers[i].fn = bc->fn;
+		workers[i].iterations = opt_iterations;
+		workers[i].samples = samples + i * opt_iterations;
+		threads[i] = g_thread_new(bc->name, bench_worker_run, &workers[i]);
+	}
+
+	for (i = 0; i < thread_count; i++) {
+		g_thread_join(threads[i]);
+		start_ns = MIN(start_ns, workers[i].start_ns);
+		end_ns = MAX(end_ns, workers[i].end_ns);
+		errors += workers[i].errors;
+	}
+
+	qsort(samples, total, sizeof(guint64), compare_samples);
+	rate = end_ns > start_ns ? total * 1e9 / (end_ns - start_ns) : 0.0;
+	printf("%-36s %3d %8d %6d %10.1f %10.1f %12.0f", bc->name, thread_count, total, errors,
+			percentile_us(samples, total, 0.50), percentile_us(samples, total, 0.99), rate);
+	if (base_rate > 0)
+		printf(" %7.2fx", rate / base_rate);
+	printf("\n");
+	fflush(stdout);
+
+	g_free(samples);
+	g_free(threads);
+	g_free(workers);
+	return rate;
+}
+
+static void scaling_run(const bench_case *bc)
+{
+	int max_threads = 2 * g_get_num_processors();
+	double base_rate = 0;
+	int thread_count = 0;
+
+	base_rate = bench_run(bc, 1, 0);
+	for (thread_count = 2; thread_count <= max_threads; thread_count *= 2)
+		bench_run(bc, thread_count, base_rate);
+}
+
+static int soak_case_count = 0;
+static const bench_case *soak_cases[G_N_ELEMENTS(cases)];
+
+static gpointer soak_worker_run(gpointer user_data)
+{
+	soak_worker *worker = user_data;
+	GMainContext *context = g_main_context_new();
+	GRand *rng = g_rand_new_with_seed(opt_seed + worker->index);
+	const bench_case *bc = NULL;
+	guint64 begin = 0;
+	guint64 sample = 0;
+	gpointer count = NULL;
+	int ret = 0;
+
+	g_main_context_push_thread_default(context);
+
+	while (g_atomic_int_get(&soak_running)) {
+		bc = soak_cases[g_rand_int_range(rng, 0, soak_case_count)];
+		begin = now_ns();
+		ret = bc->fn();
+		sample = now_ns() - begin;
+
+		g_mutex_lock(&worker->lock);
+		g_array_append_val(worker->window, sample);
+		if (ret != SIM_ERROR_NONE) {
+			worker->window_errors++;
+			count = g_hash_table_lookup(worker->errors, GINT_TO_POINTER(ret));
+			g_hash_table_insert(worker->errors, GINT_TO_POINTER(ret), GINT_TO_POINTER(GPOINTER_TO_INT(count) + 1));
+		}
+		g_mutex_unlock(&worker->lock);
+	}
+
+	g_main_context_pop_thread_default(context);
+	g_main_context_unref(context);
+	g_rand_free(rng);
+	return NULL;
+}
+
+static void soak_run(int thread_count)
+{
+	soak_worker *workers = NULL;
+	GThread **threads = NULL;
+	GArray *window = NULL;
+	GHashTable *errors = NULL;
+	GHashTableIter iter;
+	gpointer key = NULL;
+	gpointer value = NULL;
+	guint64 start_ns = 0;
+	guint64 worst_ns = 0;
+	int error_streak = 0;
+	int longest_streak = 0;
+	int window_errors = 0;
+	int i = 0;
+	int j = 0;
+
+	for (i = 0; i < (int) G_N_ELEMENTS(cases); i++) {
+		if (opt_filter == NULL || strstr(cases[i].name, opt_filter) != NULL)
+			soak_cases[soak_case_count++] = &cases[i];
+	}
+	if (soak_case_count == 0) {
+		fprintf(stderr, "sim-bench: no case matches '%s'\n", opt_filter);
+		return;
+	}
+
+	workers = g_new0(soak_worker, thread_count);
+	threads = g_new0(GThread*, thread_count);
+	window = g_array_new(FALSE, FALSE, sizeof(guint64));
+	errors = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+	g_atomic_int_set(&soak_running, 1);
+	for (i = 0; i < thread_count; i++) {
+		workers[i].index = i;
+		g_mutex_init(&workers[i].lock);
+		workers[i].window = g_array_new(FALSE, FALSE, sizeof(guint64));
+		workers[i].errors = g_hash_table_new(g_direct_hash, g_direct_equal);
+		threads[i] = g_thread_new("sim-bench-soak", soak_worker_run, &workers[i]);
+	}
+
+	printf("%8s %8s %6s %10s %10s %10s\n", "time(s)", "calls", "errors", "p50(us)", "p99(us)", "max(us)");
+	start_ns = now_ns();
+	while (now_ns() - start_ns < (guint64) opt_soak * 1000000000ULL) {
+		g_usleep(opt_interval * 1000);
+
+		g_array_set_size(window, 0);
+		window_errors = 0;
+		for (i = 0; i < thread_count; i++) {
+			g_mutex_lock(&workers[i].lock);
+			g_array_append_vals(window, workers[i].window->data, workers[i].window->len);
+			g_array_set_size(workers[i].window, 0);
+			window_errors += workers[i].window_errors;
+			workers[i].window_errors = 0;
+			g_mutex_unlock(&workers[i].lock);
+		}
+
+		error_streak = window_errors > 0 ? error_streak + 1 : 0;
+		longest_streak = MAX(longest_streak, error_streak);
+		if (window->len == 0) {
+			printf("%8.1f %8d %6d %10s %10s %10s\n", (now_ns() - start_ns) / 1e9, 0, window_errors, "-", "-", "-");
+			continue;
+		}
+		qsort(window->data, window->len, sizeof(guint64), compare_samples);
+		worst_ns = MAX(worst_ns, g_array_index(window, guint64, window->len - 1));
+		printf("%8.1f %8u %6d %10.1f %10.1f %10.1f\n", (now_ns() - start_ns) / 1e9, window->len, window_errors,
+				percentile_us((guint64*) window->data, window->len, 0.50),
+				percentile_us((guint64*) window->data, window->len, 0.99),
+				g_array_index(window, guint64, window->len - 1) / 1000.0);
+		fflush(stdout);
+	}
+
+	g_atomic_int_set(&soak_running, 0);
+	for (i = 0; i < thread_count; i++) {
+		g_thread_join(threads[i]);
+		g_hash_table_iter_init(&iter, workers[i].errors);
+		while (g_hash_table_iter_next(&iter, &key, &value)) {
+			j = GPOINTER_TO_INT(g_hash_table_lookup(errors, key));
+			g_hash_table_insert(errors, key, GINT_TO_POINTER(j + GPOINTER_TO_INT(value)));
+		}
+		g_hash_table_destroy(workers[i].errors);
+		g_array_free(workers[i].window, TRUE);
+		g_mutex_clear(&workers[i].lock);
+	}
+
+	printf("worst latency %.1f us, longest run of failing intervals %d\n", worst_ns / 1000.0, longest_streak);
+	g_hash_table_iter_init(&iter, errors);
+	while (g_hash_table_iter_next(&iter, &key, &value))
+		printf("error 0x%08x: %d\n", GPOINTER_TO_INT(key), GPOINTER_TO_INT(value));
+
+	g_hash_table_destroy(errors);
+	g_array_free(window, TRUE);
+	g_free(threads);
+	g_free(workers);
+}
+
+#ifndef SIM_BENCH_BASELINE
+static void print_stats(void)
+{
+	sim_stats_s stats;
+	int i = 0;
+
+	if (sim_get_stats(&stats) != SIM_ERROR_NONE) {
+		fprintf(stderr, "sim-bench: library statistics are not available\n");
+		return;
+	}
+
+	printf("\n%-36s %10s %8s %12s\n", "library counter", "calls", "errors", "avg(us)");
+	for (i = 0; i < stats.entry_count; i++) {
+		if (stats.entries[i].calls == 0)
+			continue;
+		printf("%-36s %10llu %8llu %12.1f\n", stats.entries[i].name, stats.entries[i].calls,
+				stats.entries[i].errors, stats.entries[i].total_ns / 1000.0 / stats.entries[i].calls);
+	}
+	for (i = 0; i < stats.error_count; i++) {
+		if (stats.errors[i].count > 0)
+			printf("error 0x%08x returned %llu times\n", stats.errors[i].error, stats.errors[i].count);
+	}
+	sim_release_stats(&stats);
+}
+#endif
+
+static void on_state_changed(sim_state_e state, void *user_data)
+{
+}
+
+/* sim_set_state_changed_cb() is all the first release has. */
+static int watch_start(int *id)
+{
+#ifdef SIM_BENCH_BASELINE
+	return sim_set_state_changed_cb(on_state_changed, NULL);
+#else
+	return sim_add_state_changed_cb(on_state_changed, NULL, id);
+#endif
+}
+
+static void watch_stop(int id)
+{
+#ifdef SIM_BENCH_BASELINE
+	sim_unset_state_changed_cb();
+#else
+	sim_remove_state_changed_cb(id);
+#endif
+}
+
+static gpointer watch_loop_run(gpointer user_data)
+{
+	g_main_loop_run(user_data);
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	GOptionEntry entries[] = {
+		{ "iterations", 'n', 0, G_OPTION_ARG_INT, &opt_iterations, "Measured calls per thread", "N" },
+		{ "warmup", 'W', 0, G_OPTION_ARG_INT, &opt_warmup, "Unmeasured calls per thread", "N" },
+		{ "threads", 't', 0, G_OPTION_ARG_STRING, &opt_threads, "Comma separated thread counts (default 1,4)", "LIST" },
+		{ "filter", 'f', 0, G_OPTION_ARG_STRING, &opt_filter, "Only run cases whose name contains STR", "STR" },
+		{ "watch", 'w', 0, G_OPTION_ARG_NONE, &opt_watch, "Register a state listener before measuring", NULL },
+		{ "soak", 's', 0, G_OPTION_ARG_INT, &opt_soak, "Run a mixed soak for SECONDS on the first thread count", "SECONDS" },
+		{ "interval", 'i', 0, G_OPTION_ARG_INT, &opt_interval, "Soak report interval in ms", "MS" },
+		{ "seed", 0, 0, G_OPTION_ARG_INT, &opt_seed, "Random seed for the soak case order", "N" },
+		{ "scaling", 'x', 0, G_OPTION_ARG_NONE, &opt_scaling, "Run each case on 1 up to 2 x CPUs threads", NULL },
+#ifndef SIM_BENCH_BASELINE
+		{ "stats", 'S', 0, G_OPTION_ARG_NONE, &opt_stats, "Print the library counters at the end", NULL },
+		{ "timeout", 'T', 0, G_OPTION_ARG_INT, &opt_timeout, "Library-wide request timeout in ms", "MS" },
+		{ "prefetch", 'p', 0, G_OPTION_ARG_NONE, &opt_prefetch, "Enable prefetch first, implies --watch", NULL },
+		{ "optimistic", 'o', 0, G_OPTION_ARG_NONE, &opt_optimistic, "Skip the init state check before each request", NULL },
+		{ "dispatch-worker", 0, 0, G_OPTION_ARG_NONE, &opt_dispatch_worker, "Invoke state callbacks from the library's thread", NULL },
+#endif
+		{ NULL }
+	};
+	GOptionContext *option_context = NULL;
+	GError *error = NULL;
+	GMainLoop *loop = NULL;
+	GThread *loop_thread = NULL;
+	gchar **thread_counts = NULL;
+	int listener_id = 0;
+	int i = 0;
+	int j = 0;
+
+	option_context = g_option_context_new("- libcapi-telephony-sim latency/throughput benchmark");
+	g_option_context_add_main_entries(option_context, entries, NULL);
+	if (!g_option_context_parse(option_context, &argc, &argv, &error) || opt_iterations < 1 || opt_interval < 1) {
+		fprintf(stderr, "sim-bench: %s\n", error != NULL ? error->message : "invalid iteration count or interval");
+		return 1;
+	}
+	g_option_context_free(option_context);
+
+#ifndef SIM_BENCH_BASELINE
+	if (opt_prefetch)
+		opt_watch = TRUE;
+	if (opt_dispatch_worker)
+		sim_set_dispatch_mode(SIM_DISPATCH_WORKER_THREAD);
+#endif
+	if (opt_watch) {
+		loop = g_main_loop_new(NULL, FALSE);
+		if (watch_start(&listener_id) != SIM_ERROR_NONE) {
+			fprintf(stderr, "sim-bench: cannot register a state listener\n");
+			return 1;
+		}
+		loop_thread = g_thread_new("sim-bench-watch", watch_loop_run, loop);
+	}
+#ifndef SIM_BENCH_BASELINE
+	/* The watch loop runs the default context, which prefetch replies are
+	 * dispatched on. */
+	if (opt_prefetch && sim_enable_prefetch() != SIM_ERROR_NONE) {
+		fprintf(stderr, "sim-bench: cannot enable prefetch\n");
+		return 1;
+	}
+
+	if (sim_set_timeout(opt_timeout) != SIM_ERROR_NONE) {
+		fprintf(stderr, "sim-bench: invalid timeout %d\n", opt_timeout);
+		return 1;
+	}
+	sim_set_optimistic_mode(opt_optimistic);
+	sim_reset_stats();
+#endif
+	thread_counts = g_strsplit(opt_threads != NULL ? opt_threads : "1,4", ",", -1);
+	if (opt_soak > 0) {
+		soak_run(MAX(atoi(thread_counts[0]), 1));
+		goto done;
+	}
+
+	printf("%-36s %3s %8s %6s %10s %10s %12s%s\n", "case", "thr", "calls", "errors", "p50(us)", "p99(us)",
+			"calls/s", opt_scaling ? "  speedup" : "");
+	if (opt_scaling) {
+		for (j = 0; j < (int) G_N_ELEMENTS(cases); j++) {
+			if (opt_filter != NULL && strstr(cases[j].name, opt_filter) == NULL)
+				continue;
+			scaling_run(&cases[j]);
+		}
+		goto done;
+	}
+
+	for (i = 0; thread_counts[i] != NULL; i++) {
+		int thread_count = atoi(thread_counts[i]);
+
+		if (thread_count < 1)
+			continue;
+		for (j = 0; j < (int) G_N_ELEMENTS(cases); j++) {
+			if (opt_filter != NULL && strstr(cases[j].name, opt_filter) == NULL)
+				continue;
+			bench_run(&cases[j], thread_count, 0);
+		}
+	}
+
+done:
+	g_strfreev(thread_counts);
+#ifndef SIM_BENCH_BASELINE
+	if (opt_stats)
+		print_stats();
+#endif
+
+	if (opt_watch) {
+		watch_stop(listener_id);
+		g_main_loop_quit(loop);
+		g_thread_join(loop_thread);
+		g_main_loop_unref(loop);
+	}
+	return 0;
+}
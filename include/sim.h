@@ -19,6 +19,8 @@
 #define __TIZEN_TELEPHONY_SIM_H__
 
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <tizen.h>
 
 
@@ -30,6 +32,12 @@
 /**
  * @file sim.h
  * @brief This file contains the SIM APIs and related enumeration.
+ * @details All functions may be called from any number of threads at once. Each thread keeps the telephony
+ * handle it used last, and requests on the shared D-Bus connection do not wait for each other, so concurrent
+ * callers do not serialize. Callers reading the same value of a slot at once share one request to the telephony
+ * service and all get its reply. State change callbacks are invoked from the thread-default main context of the thread
+ * that added the first callback of a slot, or from a thread of the library, see sim_set_dispatch_mode(). They may
+ * still be running when sim_remove_state_changed_cb() returns on another thread.
  */
 
 /**
@@ -48,6 +56,9 @@ typedef enum
 	SIM_ERROR_INVALID_PARAMETER	= TIZEN_ERROR_INVALID_PARAMETER,		/**< Invalid parameter */
 	SIM_ERROR_OPERATION_FAILED	= TIZEN_ERROR_TELEPHONY_CLASS | 0x3000,	/**< Operation failed */
 	SIM_ERROR_NOT_AVAILABLE		= TIZEN_ERROR_TELEPHONY_CLASS | 0x3001,	/**< SIM is not available */ 
+	SIM_ERROR_TRUNCATED		= TIZEN_ERROR_TELEPHONY_CLASS | 0x3002,	/**< The value did not fit into the buffer and was truncated */
+	SIM_ERROR_TIMED_OUT		= TIZEN_ERROR_TELEPHONY_CLASS | 0x3003,	/**< The telephony service did not answer in time */
+	SIM_ERROR_CANCELED		= TIZEN_ERROR_TELEPHONY_CLASS | 0x3004,	/**< The request was canceled */
 } sim_error_e;
 
 /**
@@ -62,6 +73,168 @@ typedef enum
 	SIM_STATE_UNKNOWN,	/**< SIM is in transition between states */
 } sim_state_e;	
 
+/**
+ * @brief The maximum length of the Mobile Country Code, not including the terminating null byte.
+ */
+#define SIM_MCC_LEN 3
+
+/**
+ * @brief The maximum length of the Mobile Network Code, not including the terminating null byte.
+ */
+#define SIM_MNC_LEN 3
+
+/**
+ * @brief The maximum length of the Mobile Subscription Identification Number, not including the terminating null byte.
+ */
+#define SIM_MSIN_LEN 10
+
+/**
+ * @brief The International Mobile Subscriber Identity (IMSI) of SIM card, split into its parts.
+ */
+typedef struct
+{
+	char mcc[SIM_MCC_LEN + 1];	/**< The Mobile Country Code */
+	char mnc[SIM_MNC_LEN + 1];	/**< The Mobile Network Code */
+	char msin[SIM_MSIN_LEN + 1];	/**< The Mobile Subscription Identification Number */
+} sim_imsi_info_s;
+
+/**
+ * @brief The handle of the list of subscriber numbers (MSISDN) stored in SIM card.
+ * @see sim_get_msisdn_list()
+ */
+typedef struct sim_msisdn_list_s *sim_msisdn_list_h;
+
+/**
+ * @brief The state and the identity of SIM card, read at once with sim_get_snapshot().
+ * @remarks The string members are NULL if the value is not stored in SIM card.
+ */
+typedef struct
+{
+	sim_state_e state;		/**< The state of SIM */
+	char *icc_id;			/**< The Integrated Circuit Card IDentification */
+	sim_imsi_info_s imsi_info;	/**< The International Mobile Subscriber Identity */
+	char *spn;			/**< The Service Provider Name */
+	char *cphs_full_name;		/**< The full name of CPHS operator */
+	char *cphs_short_name;		/**< The short name of CPHS operator */
+	char *subscriber_number;	/**< The subscriber number */
+} sim_snapshot_s;
+
+/**
+ * @brief An elementary file of SIM card to read with sim_read_files().
+ */
+typedef struct
+{
+	unsigned short file_id;	/**< The identifier of the elementary file, e.g. 0x6FAD for EF_AD */
+	unsigned char record;	/**< The record to read from a linear fixed file starting from 1, or 0 to read a transparent file */
+} sim_file_s;
+
+/**
+ * @brief The result of reading one file with sim_read_files().
+ */
+typedef struct
+{
+	int error;		/**< #SIM_ERROR_NONE, or the error of this file */
+	size_t offset;		/**< The offset of the content in the buffer passed to sim_read_files() */
+	size_t length;		/**< The length of the content, 0 if the file does not exist */
+	unsigned char sw1;	/**< The first status word of the card, 0 if the card was not reached */
+	unsigned char sw2;	/**< The second status word of the card */
+} sim_file_result_s;
+
+/**
+ * @brief The length of an ISO 3166-1 alpha-2 country code, not including the terminating null byte.
+ */
+#define SIM_COUNTRY_LEN 2
+
+/**
+ * @brief The maximum length of the operator name in #sim_home_operator_info_s, not including the terminating null byte.
+ */
+#define SIM_OPERATOR_NAME_LEN 95
+
+/**
+ * @brief Enumeration of where the operator name returned by sim_get_home_operator_info() comes from.
+ */
+typedef enum
+{
+	SIM_OPERATOR_NAME_NONE,		/**< No name is known */
+	SIM_OPERATOR_NAME_SPN,		/**< The Service Provider Name stored in SIM card */
+	SIM_OPERATOR_NAME_CPHS,		/**< The CPHS operator name stored in SIM card */
+	SIM_OPERATOR_NAME_TABLE,	/**< The operator table built into the library */
+} sim_operator_name_source_e;
+
+/**
+ * @brief The home network of SIM card, read with sim_get_home_operator_info().
+ */
+typedef struct
+{
+	char mcc[SIM_MCC_LEN + 1];		/**< The Mobile Country Code */
+	char mnc[SIM_MNC_LEN + 1];		/**< The Mobile Network Code */
+	char country[SIM_COUNTRY_LEN + 1];	/**< The ISO 3166-1 alpha-2 code of the country, empty if unknown */
+	char name[SIM_OPERATOR_NAME_LEN + 1];	/**< The name to display for the operator, empty if unknown */
+	sim_operator_name_source_e name_source;	/**< Where @a name comes from */
+} sim_home_operator_info_s;
+
+/**
+ * @brief A change of the state of SIM card, read with sim_read_events().
+ */
+typedef struct
+{
+	int slot;			/**< The index of SIM slot, starting from 0 */
+	sim_state_e state;		/**< The new state of SIM */
+	long long timestamp;		/**< When the change was notified, in microseconds of CLOCK_MONOTONIC */
+} sim_event_s;
+
+/**
+ * @brief Enumeration for where state change callbacks are invoked, see sim_set_dispatch_mode().
+ */
+typedef enum
+{
+	SIM_DISPATCH_CALLER_CONTEXT,	/**< The thread-default main context of the thread that adds the first callback of a slot */
+	SIM_DISPATCH_WORKER_THREAD,	/**< A thread owned by the library, which runs a main context of its own */
+} sim_dispatch_mode_e;
+
+/**
+ * @brief The timeout value that selects the library-wide timeout.
+ * @see sim_set_timeout()
+ */
+#define SIM_TIMEOUT_DEFAULT (-1)
+
+/**
+ * @brief The handle of a token which cancels the requests it is passed to.
+ * @see sim_cancellable_create()
+ */
+typedef struct sim_cancellable_s *sim_cancellable_h;
+
+/**
+ * @brief Called when a string value requested from SIM card is available.
+ * @param[in] error #SIM_ERROR_NONE on success, otherwise the error of the request
+ * @param[in] value The requested value, or NULL if it is not stored in SIM card or @a error is not #SIM_ERROR_NONE. \n
+ * It is valid only in this function.
+ * @param[in] user_data The user data passed from the request function
+ * @see sim_get_icc_id_async()
+ * @see sim_get_spn_async()
+ * @see sim_get_subscriber_number_async()
+ */
+typedef void (*sim_get_string_cb)(sim_error_e error, const char *value, void *user_data);
+
+/**
+ * @brief Called when the IMSI requested from SIM card is available.
+ * @param[in] error #SIM_ERROR_NONE on success, otherwise the error of the request
+ * @param[in] imsi_info The IMSI of SIM card, or NULL if @a error is not #SIM_ERROR_NONE. It is valid only in this function.
+ * @param[in] user_data The user data passed from the request function
+ * @see sim_get_imsi_info_async()
+ */
+typedef void (*sim_get_imsi_info_cb)(sim_error_e error, const sim_imsi_info_s *imsi_info, void *user_data);
+
+/**
+ * @brief Called when the CPHS operator name requested from SIM card is available.
+ * @param[in] error #SIM_ERROR_NONE on success, otherwise the error of the request
+ * @param[in] full_name The full name of CPHS operator, or NULL. It is valid only in this function.
+ * @param[in] short_name The short name of CPHS operator, or NULL. It is valid only in this function.
+ * @param[in] user_data The user data passed from the request function
+ * @see sim_get_cphs_operator_name_async()
+ */
+typedef void (*sim_get_cphs_operator_name_cb)(sim_error_e error, const char *full_name, const char *short_name, void *user_data);
+
 
 /**
  * @brief Gets the Integrated Circuit Card IDentification (ICC-ID).
@@ -74,6 +247,7 @@ typedef enum
  * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -81,6 +255,48 @@ typedef enum
  */
 int sim_get_icc_id(char **icc_id);
 
+/**
+ * @brief Gets the ICC-ID into a buffer provided by you.
+ * @details This function works like sim_get_icc_id(), but writes the value as a null-terminated string into @a icc_id
+ * instead of allocating memory for it. If the value is not stored in SIM card, an empty string is written.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] icc_id The buffer to write the ICC-ID to
+ * @param[in] len The size of @a icc_id in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED @a icc_id is too small; the value written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_icc_id()
+ *
+ */
+int sim_get_icc_id_r(char *icc_id, size_t len);
+
+/**
+ * @brief Requests the Integrated Circuit Card IDentification (ICC-ID) without blocking.
+ * @details The request is sent and this function returns immediately. @a callback is invoked once with the result
+ * from the thread-default main context of the calling thread, which must run a main loop.
+ * Several requests may be outstanding at the same time.
+ *
+ * @param[in] callback The callback function to invoke with the result
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_get_string_cb() will be invoked.
+ * @see sim_get_icc_id()
+ *
+ */
+int sim_get_icc_id_async(sim_get_string_cb callback, void *user_data);
+
 /**
  * @brief Gets the Mobile Country Code (MCC) of SIM provider.
  * @details The Mobile Country Code is embedded in the SIM card.
@@ -93,6 +309,7 @@ int sim_get_icc_id(char **icc_id);
  * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory 
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -100,6 +317,29 @@ int sim_get_icc_id(char **icc_id);
  */
 int sim_get_mcc(char **mcc);
 
+/**
+ * @brief Gets the Mobile Country Code (MCC) of SIM provider into a buffer provided by you.
+ * @details This function works like sim_get_mcc(), but writes the value as a null-terminated string into @a mcc
+ * instead of allocating memory for it. If the value is not stored in SIM card, an empty string is written.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] mcc The buffer to write the Mobile Country Code to
+ * @param[in] len The size of @a mcc in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED @a mcc is too small; the value written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_mcc()
+ *
+ */
+int sim_get_mcc_r(char *mcc, size_t len);
+
 /**
  * @brief Gets the Mobile Network Code (MNC) of SIM provider.
  * @details This function gets Mobile Network Code embedded in SIM card.
@@ -111,6 +351,7 @@ int sim_get_mcc(char **mcc);
  * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory 
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -118,6 +359,29 @@ int sim_get_mcc(char **mcc);
  */
 int sim_get_mnc(char **mnc);
 
+/**
+ * @brief Gets the Mobile Network Code (MNC) of SIM provider into a buffer provided by you.
+ * @details This function works like sim_get_mnc(), but writes the value as a null-terminated string into @a mnc
+ * instead of allocating memory for it. If the value is not stored in SIM card, an empty string is written.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] mnc The buffer to write the Mobile Network Code to
+ * @param[in] len The size of @a mnc in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED @a mnc is too small; the value written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_mnc()
+ *
+ */
+int sim_get_mnc_r(char *mnc, size_t len);
+
 /**
  * @brief Gets the Mobile Subscription Identification Number (MSIN) of SIM provider.
  * @details This function gets Mobile Subscription Identification Number embedded in SIM card.
@@ -129,6 +393,7 @@ int sim_get_mnc(char **mnc);
  * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -136,6 +401,67 @@ int sim_get_mnc(char **mnc);
  */
 int sim_get_msin(char **msin);
 
+/**
+ * @brief Gets the Mobile Subscription Identification Number (MSIN) of SIM provider into a buffer provided by you.
+ * @details This function works like sim_get_msin(), but writes the value as a null-terminated string into @a msin
+ * instead of allocating memory for it. If the value is not stored in SIM card, an empty string is written.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] msin The buffer to write the Mobile Subscription Identification Number to
+ * @param[in] len The size of @a msin in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED @a msin is too small; the value written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_msin()
+ *
+ */
+int sim_get_msin_r(char *msin, size_t len);
+
+/**
+ * @brief Gets the International Mobile Subscriber Identity (IMSI) of SIM card.
+ * @details This function gets the Mobile Country Code, the Mobile Network Code and the
+ * Mobile Subscription Identification Number with a single request to SIM card.
+ * Use this instead of calling sim_get_mcc(), sim_get_mnc() and sim_get_msin() one after another.
+ *
+ * @param[out] imsi_info The IMSI of SIM card
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_state()
+ *
+ */
+int sim_get_imsi_info(sim_imsi_info_s *imsi_info);
+
+/**
+ * @brief Requests the International Mobile Subscriber Identity (IMSI) of SIM card without blocking.
+ * @details The request is sent and this function returns immediately. @a callback is invoked once with the result
+ * from the thread-default main context of the calling thread, which must run a main loop.
+ * Several requests may be outstanding at the same time.
+ *
+ * @param[in] callback The callback function to invoke with the result
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_get_imsi_info_cb() will be invoked.
+ * @see sim_get_imsi_info()
+ *
+ */
+int sim_get_imsi_info_async(sim_get_imsi_info_cb callback, void *user_data);
+
 /**
  * @brief Gets the Service Provider Name (SPN) of SIM card.
  * @details This function gets Service Provider Name embedded in SIM card.
@@ -146,6 +472,7 @@ int sim_get_msin(char **msin);
  * @retval #SIM_ERROR_NONE Successful
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -153,6 +480,48 @@ int sim_get_msin(char **msin);
  */
 int sim_get_spn(char **spn);
 
+/**
+ * @brief Gets the Service Provider Name (SPN) of SIM card into a buffer provided by you.
+ * @details This function works like sim_get_spn(), but writes the value as a null-terminated string into @a spn
+ * instead of allocating memory for it. If the value is not stored in SIM card, an empty string is written.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] spn The buffer to write the Service Provider Name to
+ * @param[in] len The size of @a spn in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED @a spn is too small; the value written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_spn()
+ *
+ */
+int sim_get_spn_r(char *spn, size_t len);
+
+/**
+ * @brief Requests the Service Provider Name (SPN) of SIM card without blocking.
+ * @details The request is sent and this function returns immediately. @a callback is invoked once with the result
+ * from the thread-default main context of the calling thread, which must run a main loop.
+ * Several requests may be outstanding at the same time.
+ *
+ * @param[in] callback The callback function to invoke with the result
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_get_string_cb() will be invoked.
+ * @see sim_get_spn()
+ *
+ */
+int sim_get_spn_async(sim_get_string_cb callback, void *user_data);
+
 /**
  * @brief Gets the Operator Name String (ONS) of Common PCN Handset Specification (CPHS) in SIM card.
  * @details This function gets the full name and the short name of CPHS operator embedded in SIM card.
@@ -164,6 +533,7 @@ int sim_get_spn(char **spn);
  * @retval #SIM_ERROR_NONE Successful
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -171,13 +541,62 @@ int sim_get_spn(char **spn);
  */
 int sim_get_cphs_operator_name(char** full_name, char** short_name);
 
+/**
+ * @brief Gets the Operator Name String (ONS) of CPHS in SIM card into buffers provided by you.
+ * @details This function works like sim_get_cphs_operator_name(), but writes the names as null-terminated strings
+ * into @a full_name and @a short_name instead of allocating memory for them.
+ * A name that is not stored in SIM card is written as an empty string.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] full_name The buffer to write the full name of CPHS operator to
+ * @param[in] full_len The size of @a full_name in bytes, including the terminating null byte
+ * @param[out] short_name The buffer to write the short name of CPHS operator to
+ * @param[in] short_len The size of @a short_name in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED A buffer is too small; the name written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_cphs_operator_name()
+ *
+ */
+int sim_get_cphs_operator_name_r(char *full_name, size_t full_len, char *short_name, size_t short_len);
+
+/**
+ * @brief Requests the Operator Name String (ONS) of CPHS in SIM card without blocking.
+ * @details The request is sent and this function returns immediately. @a callback is invoked once with the result
+ * from the thread-default main context of the calling thread, which must run a main loop.
+ * Several requests may be outstanding at the same time.
+ *
+ * @param[in] callback The callback function to invoke with the result
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_get_cphs_operator_name_cb() will be invoked.
+ * @see sim_get_cphs_operator_name()
+ *
+ */
+int sim_get_cphs_operator_name_async(sim_get_cphs_operator_name_cb callback, void *user_data);
+
 /**
  * @brief Gets the state of SIM.
  *
+ * @remarks While a callback function for sim card state changes is registered, the state is kept up to date
+ * in memory and this function returns it without asking SIM card.
+ *
  * @param[out] sim_state The current state of SIM
  * @return 0 on success, otherwise a negative error value.
  * @retval #SIM_ERROR_NONE Successful
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  *
  */
@@ -195,6 +614,7 @@ int sim_get_state(sim_state_e *sim_state);
  * @retval #SIM_ERROR_NONE Successful
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
  * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
  * @pre The SIM state must be #SIM_STATE_AVAILABLE.
  * @see	sim_get_state()
@@ -203,45 +623,1050 @@ int sim_get_state(sim_state_e *sim_state);
 int sim_get_subscriber_number(char **subscriber_number);
 
 /**
- * @brief Called when sim card state changes.
- * @param [in] state The status of sim
- * @param [in] user_data The user data passed from the callback registration function
- * @pre This callback function is invoked if you register this function using sim_set_state_changed_cb(). 
- * 
- * @see sim_set_state_changed_cb()
- * @see sim_unset_state_changed_cb()
+ * @brief Gets the SIM card subscriber number into a buffer provided by you.
+ * @details This function works like sim_get_subscriber_number(), but writes the value as a null-terminated string into @a subscriber_number
+ * instead of allocating memory for it. If the value is not stored in SIM card, an empty string is written.
+ *
+ * @remarks Only a value kept in memory while a state change callback is registered is copied without allocating
+ * memory. Otherwise the value is read from SIM card, and the library allocates and frees memory while doing so.
+ *
+ * @param[out] subscriber_number The buffer to write the subscriber number to
+ * @param[in] len The size of @a subscriber_number in bytes, including the terminating null byte
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TRUNCATED @a subscriber_number is too small; the value written to it is truncated
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_get_subscriber_number()
+ *
  */
-typedef void(* sim_state_changed_cb)(sim_state_e state, void *user_data);
+int sim_get_subscriber_number_r(char *subscriber_number, size_t len);
 
 /**
- * @brief Registers a callback function to be invoked when sim card state changes. 
+ * @brief Requests the SIM card subscriber number without blocking.
+ * @details The request is sent and this function returns immediately. @a callback is invoked once with the result
+ * from the thread-default main context of the calling thread, which must run a main loop.
+ * Several requests may be outstanding at the same time.
  *
- * @remarks You can register several callback functions.   
+ * @param[in] callback The callback function to invoke with the result
+ * @param[in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_get_string_cb() will be invoked.
+ * @see sim_get_subscriber_number()
  *
- * @param [in] callback	The callback function to register
- * @param [in] user_data The user data to be passed to the callback function
- * @param [out] id A callback ID
+ */
+int sim_get_subscriber_number_async(sim_get_string_cb callback, void *user_data);
+
+/**
+ * @brief Gets all subscriber numbers (MSISDN) stored in SIM card.
+ * @details sim_get_subscriber_number() returns only the first number. Cards with several lines store one
+ * entry, made of a number and a name, per line. The entries are read on demand from the list with
+ * sim_msisdn_list_get_count() and sim_msisdn_list_get_at().
+ *
+ * @remarks @a list must be released with sim_msisdn_list_destroy() by you.
+ *
+ * @param[out] list The list of subscriber numbers
  * @return 0 on success, otherwise a negative error value.
  * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
  * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
  * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
- * @post sim_state_changed_cb() will be invoked. 
- * @see sim_state_changed_cb()
- * @see	sim_unset_state_changed_cb()
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see	sim_msisdn_list_destroy()
+ *
  */
-int sim_set_state_changed_cb(sim_state_changed_cb callback, void *user_data);
+int sim_get_msisdn_list(sim_msisdn_list_h *list);
 
 /**
- * @brief Unregisters the callback function.
- * 
- * @param [in] id The callback ID
+ * @brief Gets the number of entries in a list of subscriber numbers.
+ *
+ * @param[in] list The list of subscriber numbers
+ * @param[out] count The number of entries
  * @return 0 on success, otherwise a negative error value.
  * @retval #SIM_ERROR_NONE Successful
- * @retval #SIM_ERROR_OPERATION_FAILED Operation failed.  
- * @see	sim_set_state_changed_cb()
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see	sim_get_msisdn_list()
  *
  */
-int sim_unset_state_changed_cb();
+int sim_msisdn_list_get_count(sim_msisdn_list_h list, int *count);
+
+/**
+ * @brief Gets an entry of a list of subscriber numbers.
+ *
+ * @remarks @a number and @a name are owned by @a list and valid until it is destroyed. Do not free them.
+ *
+ * @param[in] list The list of subscriber numbers
+ * @param[in] index The index of the entry, from 0 to the count of entries - 1
+ * @param[out] number The subscriber number, or NULL if it is not stored
+ * @param[out] name The name of the subscriber number, or NULL if it is not stored
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see	sim_msisdn_list_get_count()
+ *
+ */
+int sim_msisdn_list_get_at(sim_msisdn_list_h list, int index, const char **number, const char **name);
+
+/**
+ * @brief Destroys a list of subscriber numbers.
+ *
+ * @param[in] list The list of subscriber numbers
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see	sim_get_msisdn_list()
+ *
+ */
+int sim_msisdn_list_destroy(sim_msisdn_list_h list);
+
+/**
+ * @brief Gets the state of SIM and, if SIM is available, all identity values of SIM card at once.
+ * @details This function checks the state of SIM once and then sends the requests for the ICC-ID, the IMSI,
+ * the SPN, the CPHS operator name and the subscriber number together, so it takes about as long as a single request.
+ * Use this instead of calling sim_get_state(), sim_get_icc_id(), sim_get_imsi_info(), sim_get_spn(),
+ * sim_get_cphs_operator_name() and sim_get_subscriber_number() one after another. \n
+ * If the state of SIM is not #SIM_STATE_AVAILABLE, only @c state is set and #SIM_ERROR_NONE is returned.
+ *
+ * @remarks @a snapshot must be released with sim_release_snapshot() by you.
+ *
+ * @param[out] snapshot The state and the identity of SIM card
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @see sim_release_snapshot()
+ *
+ */
+int sim_get_snapshot(sim_snapshot_s *snapshot);
+
+/**
+ * @brief Releases the values held by a snapshot taken with sim_get_snapshot().
+ *
+ * @param[in] snapshot The snapshot to release
+ * @see sim_get_snapshot()
+ *
+ */
+void sim_release_snapshot(sim_snapshot_s *snapshot);
+
+/**
+ * @brief Sets the timeout of each request the library sends to the telephony service.
+ * @details The getters fail with #SIM_ERROR_TIMED_OUT instead of waiting longer than this for the telephony service.
+ * It applies to every getter except the *_timed ones called with their own timeout.
+ * The default is the timeout of D-Bus, 25 seconds.
+ *
+ * @param[in] timeout_ms The timeout in milliseconds, or #SIM_TIMEOUT_DEFAULT to restore the default
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_get_timeout()
+ *
+ */
+int sim_set_timeout(int timeout_ms);
+
+/**
+ * @brief Gets the timeout set with sim_set_timeout().
+ *
+ * @param[out] timeout_ms The timeout in milliseconds, or #SIM_TIMEOUT_DEFAULT
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_set_timeout()
+ *
+ */
+int sim_get_timeout(int *timeout_ms);
+
+/**
+ * @brief Creates a token to cancel requests made with the *_timed getters.
+ * @details One token can be passed to any number of requests, from any thread.
+ *
+ * @remarks @a cancellable must be released with sim_cancellable_destroy() by you.
+ *
+ * @param[out] cancellable The token
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_cancellable_cancel()
+ * @see sim_cancellable_destroy()
+ *
+ */
+int sim_cancellable_create(sim_cancellable_h *cancellable);
+
+/**
+ * @brief Cancels the requests made with a token.
+ * @details The requests waiting for the telephony service fail with #SIM_ERROR_CANCELED right away,
+ * and so do the requests made with the token later, until sim_cancellable_reset() is called.
+ *
+ * @param[in] cancellable The token
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_cancellable_reset()
+ *
+ */
+int sim_cancellable_cancel(sim_cancellable_h cancellable);
+
+/**
+ * @brief Makes a canceled token usable for new requests.
+ *
+ * @param[in] cancellable The token
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_cancellable_cancel()
+ *
+ */
+int sim_cancellable_reset(sim_cancellable_h cancellable);
+
+/**
+ * @brief Destroys a token.
+ * @remarks No request may be using @a cancellable any more.
+ *
+ * @param[in] cancellable The token
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_cancellable_destroy(sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the Integrated Circuit Card IDentification (ICC-ID), within a timeout and cancellably.
+ * @details The same as sim_get_icc_id(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @remarks @c icc_id must be released with free() by you.
+ *
+ * @param[out] icc_id The Integrated Circuit Card IDentification
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_icc_id()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_icc_id_timed(char **icc_id, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the International Mobile Subscriber Identity (IMSI), within a timeout and cancellably.
+ * @details The same as sim_get_imsi_info(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @param[out] imsi_info The International Mobile Subscriber Identity
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_imsi_info()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_imsi_info_timed(sim_imsi_info_s *imsi_info, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the Service Provider Name (SPN), within a timeout and cancellably.
+ * @details The same as sim_get_spn(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @remarks @c spn must be released with free() by you.
+ *
+ * @param[out] spn The Service Provider Name
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_spn()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_spn_timed(char **spn, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the Operator Name String (ONS) and the short form of ONS, within a timeout and cancellably.
+ * @details The same as sim_get_cphs_operator_name(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @remarks @c full_name and @c short_name must be released with free() by you.
+ *
+ * @param[out] full_name The full name of CPHS operator
+ * @param[out] short_name The short name of CPHS operator
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_cphs_operator_name()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_cphs_operator_name_timed(char **full_name, char **short_name, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the state of SIM, within a timeout and cancellably.
+ * @details The same as sim_get_state(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @param[out] sim_state The current state of SIM
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @see sim_get_state()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_state_timed(sim_state_e *sim_state, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the SIM card subscriber number, within a timeout and cancellably.
+ * @details The same as sim_get_subscriber_number(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @remarks @c subscriber_number must be released with free() by you.
+ *
+ * @param[out] subscriber_number The subscriber number in SIM
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @pre The SIM state must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_subscriber_number()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_subscriber_number_timed(char **subscriber_number, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Gets the state of SIM and all identity values of SIM card at once, within a timeout and cancellably.
+ * @details The same as sim_get_snapshot(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled.
+ *
+ * @remarks @a snapshot must be released with sim_release_snapshot() by you.
+ *
+ * @param[out] snapshot The state and the identity of SIM card
+ * @param[in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param[in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @see sim_get_snapshot()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_get_snapshot_timed(sim_snapshot_s *snapshot, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Called when sim card state changes.
+ * @param [in] state The status of sim
+ * @param [in] user_data The user data passed from the callback registration function
+ * @pre This callback function is invoked if you register this function using sim_set_state_changed_cb(). 
+ * 
+ * @see sim_set_state_changed_cb()
+ * @see sim_unset_state_changed_cb()
+ */
+typedef void(* sim_state_changed_cb)(sim_state_e state, void *user_data);
+
+/**
+ * @brief Registers a callback function to be invoked when sim card state changes. 
+ *
+ * @remarks You can register several callback functions. \n
+ * While a callback is registered, values read from SIM card such as ICC-ID, IMSI, SPN, CPHS operator name
+ * and subscriber number are kept in memory and returned without asking SIM card again, until the SIM state changes.
+ *
+ * @param [in] callback	The callback function to register
+ * @param [in] user_data The user data to be passed to the callback function
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_state_changed_cb() will be invoked. 
+ * @see sim_state_changed_cb()
+ * @see	sim_unset_state_changed_cb()
+ */
+int sim_set_state_changed_cb(sim_state_changed_cb callback, void *user_data);
+
+/**
+ * @brief Unregisters all the callback functions registered with sim_set_state_changed_cb().
+ * 
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed.  
+ * @see	sim_set_state_changed_cb()
+ *
+ */
+int sim_unset_state_changed_cb();
+
+/**
+ * @brief Adds a callback function to be invoked when sim card state changes.
+ * @details Any number of callback functions can be added. All of them share one subscription to the state
+ * changes of SIM card, so adding and removing them is cheap.
+ *
+ * @remarks While a callback is registered, values read from SIM card are kept in memory as described in
+ * sim_set_state_changed_cb().
+ *
+ * @param [in] callback	The callback function to add
+ * @param [in] user_data The user data to be passed to the callback function
+ * @param [out] id The ID of the added callback, to be passed to sim_remove_state_changed_cb()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_state_changed_cb() will be invoked.
+ * @see sim_state_changed_cb()
+ * @see	sim_remove_state_changed_cb()
+ */
+int sim_add_state_changed_cb(sim_state_changed_cb callback, void *user_data, int *id);
+
+/**
+ * @brief Removes a callback function added with sim_add_state_changed_cb() or sim_slot_add_state_changed_cb().
+ *
+ * @param [in] id The ID of the callback
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @see	sim_add_state_changed_cb()
+ *
+ */
+int sim_remove_state_changed_cb(int id);
+
+/**
+ * @brief Sets the time to collapse bursts of sim card state changes into one callback.
+ * @details Callback functions are invoked only when the state of SIM really changes. In addition, when @a msec
+ * is not 0, a state change opens a window of @a msec milliseconds and only the state at its end is delivered,
+ * so the transitions SIM card goes through while the modem boots or the card is swapped reach you once.
+ * The default is 0, which delivers every state change right away.
+ *
+ * @param [in] msec The debounce time in milliseconds, or 0 to disable it
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @see	sim_add_state_changed_cb()
+ * @see	sim_set_state_changed_cb()
+ *
+ */
+int sim_set_state_changed_debounce_time(unsigned int msec);
+
+/**
+ * @brief The number of latency buckets in #sim_stats_entry_s.
+ */
+#define SIM_STATS_HISTOGRAM_BUCKETS 40
+
+/**
+ * @brief Call counters and latency histogram of one API or of one call the library makes.
+ * @details Bucket @a i of @c histogram counts the calls that took from 2^i up to 2^(i+1) nanoseconds,
+ * the last bucket also counts slower calls.
+ */
+typedef struct
+{
+	const char *name;	/**< The API name, the libtapi function name such as "tel_init", or "dbus:" and the D-Bus method name */
+	unsigned long long calls;	/**< The number of calls */
+	unsigned long long errors;	/**< The number of calls that failed */
+	unsigned long long total_ns;	/**< The time spent in the calls, in nanoseconds */
+	unsigned long long histogram[SIM_STATS_HISTOGRAM_BUCKETS];	/**< The number of calls by latency */
+} sim_stats_entry_s;
+
+/**
+ * @brief The number of times the APIs returned an error.
+ */
+typedef struct
+{
+	sim_error_e error;	/**< The error */
+	unsigned long long count;	/**< The number of times any API returned @c error */
+} sim_stats_error_s;
+
+/**
+ * @brief The counters of the library, read with sim_get_stats().
+ */
+typedef struct
+{
+	int entry_count;	/**< The number of items in @c entries */
+	sim_stats_entry_s *entries;	/**< The counters of each API and of each libtapi and D-Bus call */
+	int error_count;	/**< The number of items in @c errors */
+	sim_stats_error_s *errors;	/**< The number of failed API calls by error */
+} sim_stats_s;
+
+/**
+ * @brief Gets the call counters and latency histograms of the library.
+ * @details Every API, every libtapi call and every synchronous D-Bus call of the library is counted
+ * from the load of the library, or from the last sim_reset_stats(). The time spent in tel_init() and tel_deinit()
+ * and in D-Bus is counted separately from the time spent in the APIs that made those calls.
+ *
+ * @remarks @a stats must be released with sim_release_stats() by you. \n
+ * The counters are only kept if the library is built with statistics enabled.
+ *
+ * @param[out] stats The counters
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_NOT_AVAILABLE The library is built without statistics
+ * @see sim_release_stats()
+ * @see sim_reset_stats()
+ *
+ */
+int sim_get_stats(sim_stats_s *stats);
+
+/**
+ * @brief Releases the counters read with sim_get_stats().
+ *
+ * @param[in] stats The counters to release
+ * @see sim_get_stats()
+ *
+ */
+void sim_release_stats(sim_stats_s *stats);
+
+/**
+ * @brief Sets all counters of the library to zero.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_NOT_AVAILABLE The library is built without statistics
+ * @see sim_get_stats()
+ *
+ */
+int sim_reset_stats(void);
+
+/**
+ * @brief Gets the number of SIM slots, one for each modem of the telephony service.
+ * @details Slots are numbered from 0 to the count - 1. Slot 0 is the SIM card all functions without a slot argument
+ * refer to.
+ *
+ * @param[out] count The number of SIM slots
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ *
+ */
+int sim_get_slot_count(int *count);
+
+/**
+ * @brief Gets the Integrated Circuit Card IDentification (ICC-ID) of SIM card in a slot.
+ * @details The same as sim_get_icc_id(), for the SIM card in @a slot.
+ *
+ * @remarks @a icc_id must be released with free() by you.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] icc_id The Integrated Circuit Card Identification
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @pre The SIM state of @a slot must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_icc_id()
+ *
+ */
+int sim_slot_get_icc_id(int slot, char **icc_id);
+
+/**
+ * @brief Gets the MCC, MNC and MSIN of the IMSI of SIM card in a slot at once.
+ * @details The same as sim_get_imsi_info(), for the SIM card in @a slot.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] imsi_info The parts of the IMSI
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @pre The SIM state of @a slot must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_imsi_info()
+ *
+ */
+int sim_slot_get_imsi_info(int slot, sim_imsi_info_s *imsi_info);
+
+/**
+ * @brief Gets the Service Provider Name (SPN) of SIM card in a slot.
+ * @details The same as sim_get_spn(), for the SIM card in @a slot.
+ *
+ * @remarks @a spn must be released with free() by you.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] spn The Service Provider Name
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @pre The SIM state of @a slot must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_spn()
+ *
+ */
+int sim_slot_get_spn(int slot, char **spn);
+
+/**
+ * @brief Gets the Operator Name String (ONS) of Common PCN Handset Specification (CPHS) of SIM card in a slot.
+ * @details The same as sim_get_cphs_operator_name(), for the SIM card in @a slot.
+ *
+ * @remarks @a full_name and @a short_name must be released with free() by you.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] full_name The full name of CPHS operator name
+ * @param[out] short_name The short name of CPHS operator name
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @pre The SIM state of @a slot must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_cphs_operator_name()
+ *
+ */
+int sim_slot_get_cphs_operator_name(int slot, char **full_name, char **short_name);
+
+/**
+ * @brief Gets the state of SIM in a slot.
+ * @details The same as sim_get_state(), for the SIM card in @a slot.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] sim_state The current state of SIM
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @see sim_get_state()
+ *
+ */
+int sim_slot_get_state(int slot, sim_state_e *sim_state);
+
+/**
+ * @brief Gets the SIM card subscriber number of SIM card in a slot.
+ * @details The same as sim_get_subscriber_number(), for the SIM card in @a slot.
+ *
+ * @remarks @a subscriber_number must be released with free() by you.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] subscriber_number The subscriber number in SIM
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @pre The SIM state of @a slot must be #SIM_STATE_AVAILABLE.
+ * @see sim_get_subscriber_number()
+ *
+ */
+int sim_slot_get_subscriber_number(int slot, char **subscriber_number);
+
+/**
+ * @brief Gets the state of SIM in a slot and all identity values of its SIM card at once.
+ * @details The same as sim_get_snapshot(), for the SIM card in @a slot.
+ *
+ * @remarks @a snapshot must be released with sim_release_snapshot() by you.
+ *
+ * @param[in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param[out] snapshot The state and the identity of SIM card
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @see sim_get_snapshot()
+ * @see sim_get_all_snapshots()
+ *
+ */
+int sim_slot_get_snapshot(int slot, sim_snapshot_s *snapshot);
+
+/**
+ * @brief Gets the snapshots of all SIM slots at once.
+ * @details The slots are read concurrently, so this takes about as long as sim_get_snapshot() of a single slot.
+ * @a snapshots[i] is filled with the snapshot of slot i as sim_get_snapshot() does. If a slot fails, its snapshot
+ * only holds the state, if that could be read, the other slots are filled anyway and the error of the first failing
+ * slot is returned.
+ *
+ * @remarks Each of the @a count snapshots must be released with sim_release_snapshot() by you.
+ *
+ * @param[out] snapshots The array to fill, one item per slot
+ * @param[in] max_count The number of items of @a snapshots
+ * @param[out] count The number of snapshots filled, the number of slots if not more than @a max_count
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @see sim_get_slot_count()
+ * @see sim_slot_get_snapshot()
+ *
+ */
+int sim_get_all_snapshots(sim_snapshot_s *snapshots, int max_count, int *count);
+
+/**
+ * @brief Called when the state of SIM card in a slot changes.
+ * @param [in] slot The SIM slot
+ * @param [in] state The status of sim
+ * @param [in] user_data The user data passed from the callback registration function
+ * @pre This callback function is invoked if you register this function using sim_slot_add_state_changed_cb().
+ *
+ * @see sim_slot_add_state_changed_cb()
+ */
+typedef void(* sim_slot_state_changed_cb)(int slot, sim_state_e state, void *user_data);
+
+/**
+ * @brief Adds a callback function to be invoked when the state of SIM card in a slot changes.
+ * @details The same as sim_add_state_changed_cb(), for the SIM card in @a slot. The debounce time set with
+ * sim_set_state_changed_debounce_time() applies to each slot separately.
+ *
+ * @param [in] slot The SIM slot, from 0 to the count returned by sim_get_slot_count() - 1
+ * @param [in] callback	The callback function to add
+ * @param [in] user_data The user data to be passed to the callback function
+ * @param [out] id The ID of the added callback, to be passed to sim_remove_state_changed_cb()
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @post sim_slot_state_changed_cb() will be invoked.
+ * @see sim_slot_state_changed_cb()
+ * @see	sim_remove_state_changed_cb()
+ */
+int sim_slot_add_state_changed_cb(int slot, sim_slot_state_changed_cb callback, void *user_data, int *id);
+
+/**
+ * @brief Starts reading the identity of SIM cards in the background as soon as they are initialized.
+ * @details For every SIM slot, the library watches the state of SIM and, whenever SIM card reports that it is
+ * initialized, reads the ICC-ID, the IMSI, the SPN, the CPHS operator name and the subscriber number at once and keeps them
+ * in memory, as while a callback is registered with sim_add_state_changed_cb(). The first sim_get_icc_id() and
+ * the like then return without asking SIM card. A SIM card which is already available when this function is
+ * called is read right away. \n
+ * Calling this function again while prefetching is enabled does nothing.
+ *
+ * @remarks The requests are dispatched from the thread-default main context of the calling thread, which must
+ * run a main loop, or by the library's worker thread in #SIM_DISPATCH_WORKER_THREAD mode. \n
+ * A burst of state changes drops the values read, which are read again once SIM card is initialized.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @see sim_disable_prefetch()
+ *
+ */
+int sim_enable_prefetch(void);
+
+/**
+ * @brief Stops reading the identity of SIM cards in the background.
+ * @details Values already read stay in memory as long as a state change callback is registered.
+ *
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @see sim_enable_prefetch()
+ *
+ */
+int sim_disable_prefetch(void);
+
+/**
+ * @brief Sets the file where the identity of SIM cards is kept across restarts.
+ * @details Once set, every value read from SIM card is also written to @a path, so that a later process can
+ * get it with sim_get_last_known_snapshot() before SIM card is initialized. Values of another card replace
+ * the recorded ones as soon as SIM card is initialized. The file is shared between all processes which set
+ * the same path. \n
+ * The file is created if needed, and reset if it was written by an incompatible version.
+ *
+ * @remarks The file holds the subscriber identity, so @a path must only be accessible to trusted processes.
+ *
+ * @param [in] path The path of the file, or NULL to stop using it
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @see sim_get_last_known_snapshot()
+ *
+ */
+int sim_set_identity_cache_file(const char *path);
+
+/**
+ * @brief Gets the identity of SIM card last recorded in the file set with sim_set_identity_cache_file().
+ * @details This function only reads the file and never asks telephony, so it can be called right at startup.
+ * @a stale is true until this process has seen SIM card initialized and checked that the recorded identity
+ * is the one of the inserted card; until then it may describe a card which has been removed. Without a state
+ * change callback for @a slot, the identity of a card telephony reports as newly inserted stays stale, since it
+ * may have been swapped for another new card since.
+ *
+ * @remarks You must release the values of @a snapshot with sim_release_snapshot(). \n
+ * The state is #SIM_STATE_UNKNOWN unless a state change callback is registered for @a slot.
+ *
+ * @param [in] slot The index of SIM slot, starting from 0
+ * @param [out] snapshot The last known identity of SIM card
+ * @param [out] stale Whether the identity has not been checked against SIM card yet
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_NOT_AVAILABLE Nothing is recorded for @a slot, or no file is set
+ * @see sim_set_identity_cache_file()
+ * @see sim_release_snapshot()
+ *
+ */
+int sim_get_last_known_snapshot(int slot, sim_snapshot_s *snapshot, bool *stale);
+
+/**
+ * @brief Enables or disables the optimistic mode of the getters.
+ * @details By default every getter first asks whether SIM card is initialized, then reads the value: two
+ * requests to the telephony service. In optimistic mode the getters read the value right away and only ask
+ * for the state of SIM card if that fails, in which case they fail with #SIM_ERROR_NOT_AVAILABLE when SIM
+ * card is not initialized. This halves the requests while SIM card is available. \n
+ * It applies to sim_get_icc_id(), sim_get_imsi_info(), sim_get_spn(), sim_get_cphs_operator_name(),
+ * sim_get_subscriber_number(), sim_get_msisdn_list(), their _r, _async, _timed and slot variants and
+ * sim_get_mcc() and the like.
+ * The default is disabled.
+ *
+ * @remarks Values read in optimistic mode are only kept in memory while a state change callback is
+ * registered, since nothing else tells the library that another card has been inserted.
+ *
+ * @param [in] enable true to send the requests without checking the state of SIM card first
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ *
+ */
+int sim_set_optimistic_mode(bool enable);
+
+/**
+ * @brief Reads raw elementary files of SIM card at once.
+ * @details All the files are requested together, so reading several files takes about as long as reading one.
+ * Their contents are packed one after the other in @a buffer, in the order of @a files, and @a results tells
+ * where each one is and whether it could be read. \n
+ * The error of each file is derived from the status words the card answered with, which are in @a results too:
+ * a file or record which does not exist is reported as #SIM_ERROR_NONE with a length of 0, and one whose access
+ * conditions are not fulfilled, e.g. while PIN is not verified, fails with #SIM_ERROR_NOT_AVAILABLE. A file whose
+ * content does not fit in what is left of @a buffer fails with #SIM_ERROR_TRUNCATED, its length still being set
+ * so that the call can be retried with a bigger buffer. \n
+ * At most 256 bytes of a transparent file are read.
+ *
+ * @param [in] files The files to read
+ * @param [in] count The number of files
+ * @param [out] buffer The buffer the contents are written to
+ * @param [in] len The size of @a buffer in bytes
+ * @param [out] results The result of each file, an array of @a count entries
+ * @return 0 on success, otherwise a negative error value. On success the error of each file is in @a results.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ *
+ */
+int sim_read_files(const sim_file_s *files, int count, unsigned char *buffer, size_t len, sim_file_result_s *results);
+
+/**
+ * @brief Reads raw elementary files of SIM card in the given slot at once.
+ * @details The same as sim_read_files(), for the SIM card in @a slot.
+ *
+ * @param [in] slot The index of SIM slot, starting from 0
+ * @param [in] files The files to read
+ * @param [in] count The number of files
+ * @param [out] buffer The buffer the contents are written to
+ * @param [in] len The size of @a buffer in bytes
+ * @param [out] results The result of each file, an array of @a count entries
+ * @return 0 on success, otherwise a negative error value. On success the error of each file is in @a results.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter, or @a slot is not a valid slot
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @see sim_read_files()
+ *
+ */
+int sim_slot_read_files(int slot, const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results);
+
+/**
+ * @brief Reads raw elementary files of SIM card at once, within a timeout and cancellably.
+ * @details The same as sim_read_files(), except that it fails with #SIM_ERROR_TIMED_OUT once @a timeout_ms have passed
+ * and with #SIM_ERROR_CANCELED once @a cancellable is canceled. A file whose request timed out or was canceled
+ * reports that error in @a results.
+ *
+ * @param [in] files The files to read
+ * @param [in] count The number of files
+ * @param [out] buffer The buffer the contents are written to
+ * @param [in] len The size of @a buffer in bytes
+ * @param [out] results The result of each file, an array of @a count entries
+ * @param [in] timeout_ms The timeout of the whole call in milliseconds, or #SIM_TIMEOUT_DEFAULT for the timeout set with sim_set_timeout()
+ * @param [in] cancellable The token to cancel the call with, or NULL
+ * @return 0 on success, otherwise a negative error value. On success the error of each file is in @a results.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within @a timeout_ms
+ * @retval #SIM_ERROR_CANCELED @a cancellable was canceled
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @see sim_read_files()
+ * @see sim_cancellable_create()
+ *
+ */
+int sim_read_files_timed(const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results, int timeout_ms, sim_cancellable_h cancellable);
+
+/**
+ * @brief Looks a network up in the operator table built into the library.
+ * @details The table is compiled into the library, so this function never asks SIM card nor the telephony service
+ * and does not allocate memory.
+ *
+ * @remarks The returned strings are static and must not be released.
+ *
+ * @param [in] mcc The Mobile Country Code, 3 digits
+ * @param [in] mnc The Mobile Network Code, 2 or 3 digits as stored in SIM card, or NULL to only get the country
+ * @param [out] country The ISO 3166-1 alpha-2 code of the country
+ * @param [out] name The brand of the operator, or NULL if the network is not in the table. May be NULL.
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_NOT_AVAILABLE The country code is not in the table
+ * @see sim_get_home_operator_info()
+ *
+ */
+int sim_lookup_operator(const char *mcc, const char *mnc, const char **country, const char **name);
+
+/**
+ * @brief Gets the country and the name to display of the home network of SIM card.
+ * @details The country comes from the MCC of the IMSI. The name is the SPN if SIM card has one, else the CPHS
+ * operator name, else the brand found with sim_lookup_operator(). Only the IMSI, the SPN and the CPHS name are read
+ * from SIM card, and only if they are not already known.
+ *
+ * @param [out] info The home network
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @retval #SIM_ERROR_TIMED_OUT The telephony service did not answer within the timeout set with sim_set_timeout()
+ * @retval #SIM_ERROR_NOT_AVAILABLE SIM is not available
+ * @see sim_lookup_operator()
+ *
+ */
+int sim_get_home_operator_info(sim_home_operator_info_s *info);
+
+/**
+ * @brief Gets a file descriptor which becomes readable when changes of the state of SIM card are pending.
+ * @details This lets a service built around poll() or epoll() get state changes without running a GLib main loop:
+ * add the descriptor to its set and call sim_read_events() whenever it is readable. The changes of every SIM slot
+ * are recorded from the first call of this function on. Calling it again returns the same descriptor. \n
+ * The state change callbacks keep working alongside.
+ *
+ * @remarks The descriptor stays open for the life of the process and must not be closed nor read directly. \n
+ * The library watches the state of SIM from a thread of its own, unless a state change callback was registered
+ * for the slot before, in which case the main context of that callback must keep running.
+ *
+ * @param [out] fd The file descriptor to poll for reading
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_OUT_OF_MEMORY Out of memory
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED Operation failed
+ * @see sim_read_events()
+ *
+ */
+int sim_get_event_fd(int *fd);
+
+/**
+ * @brief Reads the pending changes of the state of SIM card, oldest first.
+ * @details This function never blocks; @a count is 0 if nothing is pending. If more than @a max_count changes are
+ * pending, the descriptor of sim_get_event_fd() stays readable. \n
+ * Only actual changes are reported. When changes are not read in time the intermediate ones are dropped, but the
+ * last change pending for a SIM slot always shows the state SIM card is in.
+ *
+ * @param [out] events The changes
+ * @param [in] max_count The number of entries of @a events
+ * @param [out] count The number of changes written to @a events
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @retval #SIM_ERROR_OPERATION_FAILED sim_get_event_fd() has not been called
+ * @see sim_get_event_fd()
+ *
+ */
+int sim_read_events(sim_event_s *events, int max_count, int *count);
+
+/**
+ * @brief Sets where state change callbacks are invoked.
+ * @details With #SIM_DISPATCH_CALLER_CONTEXT, the default, callbacks are invoked from the thread-default main
+ * context of the thread that adds the first callback of a slot, which must keep running a main loop. With
+ * #SIM_DISPATCH_WORKER_THREAD they are invoked from a thread the library starts once and keeps for the life of
+ * the process, so callers need no main loop, but callbacks must take care of their own locking.
+ *
+ * @remarks The mode applies to the slots whose first callback is added afterwards; slots already watched keep
+ * their context until their last callback is removed.
+ *
+ * @param [in] mode Where to invoke the callbacks
+ * @return 0 on success, otherwise a negative error value.
+ * @retval #SIM_ERROR_NONE Successful
+ * @retval #SIM_ERROR_INVALID_PARAMETER Invalid parameter
+ * @see sim_add_state_changed_cb()
+ * @see sim_slot_add_state_changed_cb()
+ *
+ */
+int sim_set_dispatch_mode(sim_dispatch_mode_e mode);
 
 /**
  * @}
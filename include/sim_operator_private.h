@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TIZEN_TELEPHONY_SIM_OPERATOR_PRIVATE_H__
+#define __TIZEN_TELEPHONY_SIM_OPERATOR_PRIVATE_H__
+
+#include <sim.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Looks the network up in the table generated from data/mcc-mnc.csv.
+ * @mnc may be NULL to only get the country. SIM_ERROR_NOT_AVAILABLE if the
+ * MCC is not listed; @name is NULL if only the MCC is. The strings are
+ * static. */
+int _sim_operator_lookup(const char *mcc, const char *mnc, const char **country, const char **name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TIZEN_TELEPHONY_SIM_OPERATOR_PRIVATE_H__
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TIZEN_TELEPHONY_SIM_PERSIST_PRIVATE_H__
+#define __TIZEN_TELEPHONY_SIM_PERSIST_PRIVATE_H__
+
+#include <sim.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Slots kept in the identity cache file. */
+#define SIM_PERSIST_SLOT_MAX		4
+
+#define SIM_PERSIST_ICC_ID_LEN		23
+#define SIM_PERSIST_SPN_LEN		63
+#define SIM_PERSIST_CPHS_FULL_LEN	95
+#define SIM_PERSIST_CPHS_SHORT_LEN	63
+#define SIM_PERSIST_MSISDN_LEN		23
+
+/* In the order of sim_field_e */
+typedef enum
+{
+	SIM_PERSIST_ICC_ID,
+	SIM_PERSIST_IMSI,
+	SIM_PERSIST_SPN,
+	SIM_PERSIST_CPHS,
+	SIM_PERSIST_MSISDN,
+} sim_persist_field_e;
+
+/* The last known identity of the card in a slot. A value not stored in
+ * SIM card is an empty string with its bit set in valid. */
+typedef struct
+{
+	unsigned int valid;
+	char icc_id[SIM_PERSIST_ICC_ID_LEN + 1];
+	sim_imsi_info_s imsi_info;
+	char spn[SIM_PERSIST_SPN_LEN + 1];
+	char cphs_full_name[SIM_PERSIST_CPHS_FULL_LEN + 1];
+	char cphs_short_name[SIM_PERSIST_CPHS_SHORT_LEN + 1];
+	char subscriber_number[SIM_PERSIST_MSISDN_LEN + 1];
+} sim_persist_identity;
+
+/* Maps @path, creating it if needed; NULL closes the file. */
+int _sim_persist_open(const char *path);
+
+/* SIM_ERROR_NOT_AVAILABLE if nothing is known about @slot. */
+int _sim_persist_read(int slot, sim_persist_identity *identity);
+
+/* Stores one value read from the card in @slot. An ICC-ID different from
+ * the stored one drops the other values first. @str2 is only used by
+ * SIM_PERSIST_CPHS, @imsi only by SIM_PERSIST_IMSI. */
+void _sim_persist_store(int slot, sim_persist_field_e field, const char *str, const char *str2,
+		const sim_imsi_info_s *imsi);
+
+/* Drops everything known about @slot, another card is inserted. */
+void _sim_persist_forget(int slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TIZEN_TELEPHONY_SIM_PERSIST_PRIVATE_H__
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TIZEN_TELEPHONY_SIM_STATS_PRIVATE_H__
+#define __TIZEN_TELEPHONY_SIM_STATS_PRIVATE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* One counter set per public entry point and per libtapi / D-Bus call site. */
+typedef enum
+{
+	SIM_STAT_GET_ICC_ID,
+	SIM_STAT_GET_ICC_ID_R,
+	SIM_STAT_GET_ICC_ID_ASYNC,
+	SIM_STAT_GET_IMSI_INFO,
+	SIM_STAT_GET_IMSI_INFO_ASYNC,
+	SIM_STAT_GET_MCC,
+	SIM_STAT_GET_MCC_R,
+	SIM_STAT_GET_MNC,
+	SIM_STAT_GET_MNC_R,
+	SIM_STAT_GET_MSIN,
+	SIM_STAT_GET_MSIN_R,
+	SIM_STAT_GET_SPN,
+	SIM_STAT_GET_SPN_R,
+	SIM_STAT_GET_SPN_ASYNC,
+	SIM_STAT_GET_CPHS_OPERATOR_NAME,
+	SIM_STAT_GET_CPHS_OPERATOR_NAME_R,
+	SIM_STAT_GET_CPHS_OPERATOR_NAME_ASYNC,
+	SIM_STAT_GET_STATE,
+	SIM_STAT_GET_SUBSCRIBER_NUMBER,
+	SIM_STAT_GET_SUBSCRIBER_NUMBER_R,
+	SIM_STAT_GET_SUBSCRIBER_NUMBER_ASYNC,
+	SIM_STAT_GET_MSISDN_LIST,
+	SIM_STAT_MSISDN_LIST_GET_COUNT,
+	SIM_STAT_MSISDN_LIST_GET_AT,
+	SIM_STAT_MSISDN_LIST_DESTROY,
+	SIM_STAT_GET_SNAPSHOT,
+	SIM_STAT_RELEASE_SNAPSHOT,
+	SIM_STAT_SET_STATE_CHANGED_CB,
+	SIM_STAT_UNSET_STATE_CHANGED_CB,
+	SIM_STAT_ADD_STATE_CHANGED_CB,
+	SIM_STAT_REMOVE_STATE_CHANGED_CB,
+	SIM_STAT_SET_STATE_CHANGED_DEBOUNCE_TIME,
+	SIM_STAT_GET_ICC_ID_TIMED,
+	SIM_STAT_GET_IMSI_INFO_TIMED,
+	SIM_STAT_GET_SPN_TIMED,
+	SIM_STAT_GET_CPHS_OPERATOR_NAME_TIMED,
+	SIM_STAT_GET_STATE_TIMED,
+	SIM_STAT_GET_SUBSCRIBER_NUMBER_TIMED,
+	SIM_STAT_GET_SNAPSHOT_TIMED,
+	SIM_STAT_SET_TIMEOUT,
+	SIM_STAT_GET_TIMEOUT,
+	SIM_STAT_CANCELLABLE_CREATE,
+	SIM_STAT_CANCELLABLE_CANCEL,
+	SIM_STAT_CANCELLABLE_RESET,
+	SIM_STAT_CANCELLABLE_DESTROY,
+	SIM_STAT_GET_SLOT_COUNT,
+	SIM_STAT_SLOT_GET_ICC_ID,
+	SIM_STAT_SLOT_GET_IMSI_INFO,
+	SIM_STAT_SLOT_GET_SPN,
+	SIM_STAT_SLOT_GET_CPHS_OPERATOR_NAME,
+	SIM_STAT_SLOT_GET_STATE,
+	SIM_STAT_SLOT_GET_SUBSCRIBER_NUMBER,
+	SIM_STAT_SLOT_GET_SNAPSHOT,
+	SIM_STAT_SLOT_ADD_STATE_CHANGED_CB,
+	SIM_STAT_GET_ALL_SNAPSHOTS,
+	SIM_STAT_ENABLE_PREFETCH,
+	SIM_STAT_DISABLE_PREFETCH,
+	SIM_STAT_SET_IDENTITY_CACHE_FILE,
+	SIM_STAT_GET_LAST_KNOWN_SNAPSHOT,
+	SIM_STAT_SET_OPTIMISTIC_MODE,
+	SIM_STAT_READ_FILES,
+	SIM_STAT_SLOT_READ_FILES,
+	SIM_STAT_READ_FILES_TIMED,
+	SIM_STAT_LOOKUP_OPERATOR,
+	SIM_STAT_GET_HOME_OPERATOR_INFO,
+	SIM_STAT_GET_EVENT_FD,
+	SIM_STAT_READ_EVENTS,
+	SIM_STAT_SET_DISPATCH_MODE,
+	SIM_STAT_API_MAX,
+
+	SIM_STAT_TEL_INIT = SIM_STAT_API_MAX,
+	SIM_STAT_TEL_DEINIT,
+	SIM_STAT_TEL_REGISTER_NOTI_EVENT,
+	SIM_STAT_TEL_DEREGISTER_NOTI_EVENT,
+	SIM_STAT_TEL_GET_CP_NAME_LIST,
+
+	/* In the order of sim_field_e, see SIM_STAT_DBUS() */
+	SIM_STAT_DBUS_GET_ICCID,
+	SIM_STAT_DBUS_GET_IMSI,
+	SIM_STAT_DBUS_GET_SPN,
+	SIM_STAT_DBUS_GET_CPHS_NET_NAME,
+	SIM_STAT_DBUS_GET_MSISDN,
+	SIM_STAT_DBUS_GET_INIT_STATUS,
+
+	/* From the receipt of the Status signal to the state change callbacks */
+	SIM_STAT_DISPATCH_STATUS,
+	SIM_STAT_MAX
+} sim_stat_e;
+
+#define SIM_STAT_DBUS(field) ((sim_stat_e) (SIM_STAT_DBUS_GET_ICCID + (field)))
+
+#ifdef SIM_ENABLE_STATS
+
+unsigned long long _sim_stats_now(void);
+
+/* @error is a sim_error_e for entry points, for call sites only
+ * SIM_ERROR_NONE or not matters. */
+void _sim_stats_record(sim_stat_e stat, unsigned long long begin, int error);
+
+#define SIM_STATS_ENABLED		1
+#define SIM_STATS_NOW()			_sim_stats_now()
+#define SIM_STATS_BEGIN(var)		unsigned long long var = _sim_stats_now()
+#define SIM_STATS_END(stat, var, error)	_sim_stats_record(stat, var, error)
+
+#else
+
+#define SIM_STATS_ENABLED		0
+#define SIM_STATS_NOW()			0ULL
+#define SIM_STATS_BEGIN(var)		do { } while (0)
+#define SIM_STATS_END(stat, var, error)	do { (void) (error); } while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TIZEN_TELEPHONY_SIM_STATS_PRIVATE_H__
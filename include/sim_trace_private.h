@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TIZEN_TELEPHONY_SIM_TRACE_PRIVATE_H__
+#define __TIZEN_TELEPHONY_SIM_TRACE_PRIVATE_H__
+
+/*
+ * USDT probes of provider "capi_sim", for perf and bpftrace:
+ *
+ *   api_entry(const char *api)
+ *   api_return(const char *api, int error)	error is a sim_error_e
+ *   ipc_entry(const char *method)
+ *   ipc_return(const char *method, int result)
+ *
+ * method is the libtapi function, or the D-Bus method for D-Bus calls.
+ * result is what libtapi returned, or 0 / -1 for a D-Bus reply / failure.
+ */
+
+#ifdef SIM_ENABLE_TRACE
+
+#include <sys/sdt.h>
+
+#define SIM_TRACE_API_ENTRY(api)		DTRACE_PROBE1(capi_sim, api_entry, api)
+#define SIM_TRACE_API_RETURN(api, error)	DTRACE_PROBE2(capi_sim, api_return, api, error)
+#define SIM_TRACE_IPC_ENTRY(method)		DTRACE_PROBE1(capi_sim, ipc_entry, method)
+#define SIM_TRACE_IPC_RETURN(method, result)	DTRACE_PROBE2(capi_sim, ipc_return, method, result)
+
+#else
+
+#define SIM_TRACE_API_ENTRY(api)		do { } while (0)
+#define SIM_TRACE_API_RETURN(api, error)	do { } while (0)
+#define SIM_TRACE_IPC_ENTRY(method)		do { } while (0)
+#define SIM_TRACE_IPC_RETURN(method, result)	do { } while (0)
+
+#endif
+
+#endif // __TIZEN_TELEPHONY_SIM_TRACE_PRIVATE_H__
@@ -22,7 +22,13 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 #include <dlog.h>
+#include <sim_stats_private.h>
+#include <sim_trace_private.h>
+#include <sim_persist_private.h>
+#include <sim_operator_private.h>
 
 #include <glib.h>
 #include <glib-object.h>
@@ -44,11 +50,326 @@ struct tapi_handle {
 typedef struct sim_cb_data {
 	sim_state_e previous_state;
 	struct tapi_handle *th;
+	struct sim_slot *slot;
+	gboolean with_slot;
 	void* cb;
 	void* user_data;
 } sim_cb_data;
 
-static struct tapi_handle *ghandle = NULL;
+typedef struct sim_handle_ref {
+	struct tapi_handle *th;
+	int ref_count;
+} sim_handle_ref;
+
+/* Identity values of SIM card, each read with its own telephony request. */
+typedef enum {
+	SIM_FIELD_ICC_ID,
+	SIM_FIELD_IMSI,
+	SIM_FIELD_SPN,
+	SIM_FIELD_CPHS,
+	SIM_FIELD_MSISDN,
+	SIM_FIELD_MAX
+} sim_field_e;
+
+#define SIM_FIELD_BIT(field) (1 << (field))
+
+/* No state delivered yet. */
+#define SIM_STATE_NONE ((sim_state_e) -1)
+
+/* A value read from SIM card. str[] holds NULL for values not stored in
+ * SIM card; only SIM_FIELD_CPHS uses str[1] (the short name). For
+ * SIM_FIELD_MSISDN, list keeps all entries of the reply and str[0] is the
+ * number of the first one. */
+typedef struct sim_value {
+	gchar *str[2];
+	sim_imsi_info_s imsi;
+	GVariant *list;
+} sim_value;
+
+/* Entries are read from the aa{sv} reply on demand, never copied. */
+struct sim_msisdn_list_s {
+	GVariant *rows;
+};
+
+/* Identity of the inserted card, filled field by field on first read.
+ * generation is bumped on every invalidation so that a reply which raced
+ * with a card change is not stored. */
+typedef struct sim_cache {
+	unsigned int generation;
+	unsigned int valid;
+	int card_changed;
+	sim_value values[SIM_FIELD_MAX];
+} sim_cache;
+
+/* Cancellation token handed to the *_timed getters. */
+struct sim_cancellable_s {
+	GCancellable *cancellable;
+};
+
+/* Bounds of one blocking call: the monotonic deadline in microseconds (0
+ * for the D-Bus default timeout on every request) and the cancellable. */
+typedef struct sim_call_ctx {
+	gint64 deadline;
+	GCancellable *cancellable;
+} sim_call_ctx;
+
+/* One blocking read of a field which concurrent callers of the slot
+ * share, see _sim_get_value_shared(). Freed by the last of the leader and
+ * its followers, under flight_lock. */
+typedef struct sim_flight {
+	int ref_count;
+	gboolean done;
+	gint64 deadline;
+	int error_code;
+	sim_value value;
+} sim_flight;
+
+/* Must be a power of two. */
+#define SIM_EVENT_RING_SIZE	64
+
+/* State transitions of one slot for sim_read_events(). Single producer,
+ * on_noti_sim_status() of the slot, and single consumer, under
+ * G_LOCK(event_reader); head and tail are free-running and accessed
+ * atomically only. The producer only takes G_LOCK(event_reader) to
+ * replace the newest entry of a full ring, see _sim_event_push(). */
+typedef struct sim_event_ring {
+	volatile gint head;
+	volatile gint tail;
+	sim_state_e last_state;
+	sim_event_s events[SIM_EVENT_RING_SIZE];
+} sim_event_ring;
+
+/* Must be a power of two. */
+#define SIM_STAMP_RING_SIZE	16
+
+/* Receipt times of the Status signals of one slot, in SIM_STATS_NOW()
+ * units, from _sim_status_filter() in the GDBus worker thread to
+ * on_noti_sim_status(). Single producer and consumer like sim_event_ring. */
+typedef struct sim_stamp_ring {
+	volatile gint head;
+	volatile gint tail;
+	unsigned long long stamps[SIM_STAMP_RING_SIZE];
+} sim_stamp_ring;
+
+/* Everything kept per SIM card. Slot 0 is the modem tel_init(NULL) binds
+ * to, which all functions without a slot argument use. Members are
+ * protected by the lock named in the comment above them. */
+typedef struct sim_slot {
+	int index;
+
+	/* shared_handle: the telephony handle of the modem, see
+	 * _sim_handle_acquire(). shared_handle itself is also read without
+	 * the lock by _sim_handle_borrow(). */
+	struct sim_handle_ref *shared_handle;
+	GSList *retired_handles;
+
+	/* cache_lock, taken for reading by cache hits so that they do not
+	 * serialize */
+	GRWLock cache_lock;
+	sim_cache cache;
+
+	/* flight_lock: the reads in flight by field, flight_done is
+	 * broadcast when any of them completes. */
+	GMutex flight_lock;
+	GCond flight_done;
+	sim_flight *flights[SIM_FIELD_MAX];
+
+	/* state_listeners: the TAPI_NOTI_SIM_STATUS subscription, held while
+	 * subscriber_count > 0, and the debounced delivery. subscriber_count is
+	 * listener_count plus the internal watchers, see _sim_watch_slot_in(). */
+	struct tapi_handle *ghandle;
+	int subscriber_count;
+	int listener_count;
+	sim_state_e last_state;
+	sim_state_e pending_state;
+	unsigned long long pending_received;
+	GSource *debounce_source;
+	guint status_filter_id;
+
+	/* Atomic: the quark of the object path _sim_status_filter() matches.
+	 * Read by the filter in the GDBus worker thread. */
+	volatile gint status_path;
+	sim_stamp_ring status_stamps;
+
+	/* Atomic: set while TAPI_NOTI_SIM_STATUS is subscribed, i.e. while
+	 * card changes reach on_noti_sim_status() and invalidate the cache,
+	 * and the state mirror, see _sim_state_mirror_update(). */
+	volatile gint status_watched;
+	volatile gint state_mirror;
+
+	/* Atomic: whether the identity cache file record of the slot has been
+	 * checked against the card since init completed, see
+	 * _sim_persist_check_card(). */
+	volatile gint persist_state;
+
+	/* Atomic: set by sim_enable_prefetch(); on_noti_sim_status() then
+	 * prefetches on every INIT_COMPLETED it receives. */
+	volatile gint prefetch;
+
+	/* See sim_event_ring. */
+	sim_event_ring events;
+} sim_slot;
+
+typedef struct sim_async_data {
+	sim_slot *slot;
+	sim_field_e field;
+	struct tapi_handle *th;
+	unsigned int generation;
+	gboolean optimistic;
+	int error_code;
+	sim_value value;
+	void* cb;
+	void* user_data;
+} sim_async_data;
+
+typedef struct sim_snapshot_request {
+	struct sim_snapshot_data *sd;
+	sim_field_e field;
+} sim_snapshot_request;
+
+/* One slot of a snapshot. @pending is shared by all slots read together. */
+typedef struct sim_snapshot_data {
+	sim_slot *slot;
+	struct tapi_handle *th;
+	const sim_call_ctx *ctx;
+	int *pending;
+	unsigned int generation;
+	int error_code;
+	sim_state_e state;
+	sim_value values[SIM_FIELD_MAX];
+	sim_snapshot_request requests[SIM_FIELD_MAX];
+} sim_snapshot_data;
+
+/* Instructions and P2 of the AccessRSim request, as in TelSimRSimCmd_t. */
+#define SIM_RSIM_READ_BINARY		0xB0
+#define SIM_RSIM_READ_RECORD		0xB2
+#define SIM_RSIM_RECORD_ABSOLUTE	0x04
+
+/* One file of sim_read_files(); content is the ay of a successful reply.
+ * p3 is the length last asked for, see _sim_file_request_send(). */
+typedef struct sim_file_request {
+	struct sim_file_batch *batch;
+	const sim_file_s *file;
+	int p3;
+	gboolean resent;
+	int error_code;
+	unsigned char sw1;
+	unsigned char sw2;
+	GVariant *content;
+} sim_file_request;
+
+typedef struct sim_file_batch {
+	sim_slot *slot;
+	struct tapi_handle *th;
+	const sim_call_ctx *ctx;
+	int pending;
+	int init_error;
+	sim_file_request *requests;
+} sim_file_batch;
+
+/* Statuses missing here are SIM_STATE_UNAVAILABLE (0). */
+static const sim_state_e sim_state_table[] = {
+	[TAPI_SIM_STATUS_CARD_ERROR] = SIM_STATE_UNAVAILABLE,
+	[TAPI_SIM_STATUS_CARD_NOT_PRESENT] = SIM_STATE_UNAVAILABLE,
+	[TAPI_SIM_STATUS_SIM_INITIALIZING] = SIM_STATE_UNKNOWN,
+	[TAPI_SIM_STATUS_SIM_INIT_COMPLETED] = SIM_STATE_AVAILABLE,
+	[TAPI_SIM_STATUS_SIM_PIN_REQUIRED] = SIM_STATE_LOCKED,
+	[TAPI_SIM_STATUS_SIM_PUK_REQUIRED] = SIM_STATE_LOCKED,
+	[TAPI_SIM_STATUS_CARD_BLOCKED] = SIM_STATE_UNAVAILABLE,
+	[TAPI_SIM_STATUS_SIM_NCK_REQUIRED] = SIM_STATE_LOCKED,
+	[TAPI_SIM_STATUS_SIM_NSCK_REQUIRED] = SIM_STATE_LOCKED,
+	[TAPI_SIM_STATUS_SIM_SPCK_REQUIRED] = SIM_STATE_LOCKED,
+	[TAPI_SIM_STATUS_SIM_CCK_REQUIRED] = SIM_STATE_LOCKED,
+	[TAPI_SIM_STATUS_CARD_REMOVED] = SIM_STATE_UNAVAILABLE,
+	[TAPI_SIM_STATUS_SIM_LOCK_REQUIRED] = SIM_STATE_LOCKED,
+};
+
+static const char *sim_field_method[SIM_FIELD_MAX] = {
+	[SIM_FIELD_ICC_ID] = "GetICCID",
+	[SIM_FIELD_IMSI] = "GetIMSI",
+	[SIM_FIELD_SPN] = "GetSpn",
+	[SIM_FIELD_CPHS] = "GetCphsNetName",
+	[SIM_FIELD_MSISDN] = "GetMSISDN",
+};
+
+/* Latest mapped SIM state of a slot while TAPI_NOTI_SIM_STATUS is
+ * subscribed, so that sim_get_state() is a plain atomic load. */
+#define SIM_MIRROR_UNWATCHED	(-2)
+#define SIM_MIRROR_UNKNOWN	(-1)
+
+/* States of sim_slot.persist_state. Until init completes the record of the
+ * identity cache file may describe a card which is not inserted anymore. */
+#define SIM_PERSIST_UNCHECKED	0
+#define SIM_PERSIST_VERIFIED	1
+#define SIM_PERSIST_REPLACING	2
+
+/* Slots beyond this are not reported by sim_get_slot_count(). */
+#define SIM_SLOT_MAX		4
+#define SIM_SLOT_DEFAULT	0
+
+#define SIM_SLOT_INIT(i) { \
+	.index = i, \
+	.last_state = SIM_STATE_NONE, \
+	.pending_state = SIM_STATE_NONE, \
+	.state_mirror = SIM_MIRROR_UNWATCHED, \
+	.events = { .last_state = SIM_STATE_NONE }, \
+}
+
+static sim_slot slots[SIM_SLOT_MAX] = {
+	SIM_SLOT_INIT(0),
+	SIM_SLOT_INIT(1),
+	SIM_SLOT_INIT(2),
+	SIM_SLOT_INIT(3),
+};
+
+/* Modem names of the slots as reported by telephony, read once. */
+static gchar **slot_names = NULL;
+G_LOCK_DEFINE_STATIC(slot_names);
+
+/* All state listeners by id, whatever their slot. */
+static GHashTable *state_listeners = NULL;
+static int next_listener_id = 1;
+/* The ids of the listeners added with sim_set_state_changed_cb(). */
+static GSList *legacy_listener_ids = NULL;
+G_LOCK_DEFINE_STATIC(state_listeners);
+
+/* Serializes sim_enable_prefetch() and sim_disable_prefetch(). */
+G_LOCK_DEFINE_STATIC(prefetch);
+static volatile gint debounce_msec = 0;
+
+/* The library's own dispatch thread, see sim_set_dispatch_mode(). Started
+ * on first use, it runs worker_context for the life of the process. */
+static GMainContext *worker_context = NULL;
+G_LOCK_DEFINE_STATIC(worker);
+static volatile gint dispatch_mode = SIM_DISPATCH_CALLER_CONTEXT;
+
+/* The eventfd of sim_get_event_fd(), -1 until it is called. The slots it
+ * watches are subscribed on worker_context. */
+static volatile gint event_fd = -1;
+G_LOCK_DEFINE_STATIC(events);
+G_LOCK_DEFINE_STATIC(event_reader);
+
+/* Per slot, the library keeps one reference on the current telephony
+ * handle; handles replaced after a connection drop are parked in
+ * retired_handles until their last user releases them. */
+G_LOCK_DEFINE_STATIC(shared_handle);
+
+/* References a thread holds on the handles of the slots it used last, so
+ * that the getters find their handle without taking shared_handle. */
+typedef struct sim_thread_handles {
+	sim_handle_ref *refs[SIM_SLOT_MAX];
+} sim_thread_handles;
+
+static void _sim_thread_handles_free(gpointer data);
+static GPrivate thread_handles = G_PRIVATE_INIT(_sim_thread_handles_free);
+
+/* Library-wide timeout of each D-Bus request in ms, -1 for the D-Bus
+ * default. */
+static volatile gint call_timeout = SIM_TIMEOUT_DEFAULT;
+
+/* Whether the getters send their request without checking the init state
+ * first, see _sim_get_value_optimistic(). */
+static volatile gint optimistic_mode = FALSE;
 
 // Internal Macros
 #define SIM_CHECK_INPUT_PARAMETER(arg) \
@@ -58,555 +379,3169 @@ static struct tapi_handle *ghandle = NULL;
 		return SIM_ERROR_INVALID_PARAMETER; \
 	}
 
-#define SIM_INIT(th) \
-	th = tel_init(NULL); \
+#define SIM_CHECK_INPUT_BUFFER(buf, len) \
+	if( buf == NULL || len == 0 ) \
+	{ \
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER); \
+		return SIM_ERROR_INVALID_PARAMETER; \
+	}
+
+#define SIM_CHECK_TIMEOUT(timeout_ms) \
+	if( timeout_ms != SIM_TIMEOUT_DEFAULT && timeout_ms <= 0 ) \
+	{ \
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER); \
+		return SIM_ERROR_INVALID_PARAMETER; \
+	}
+
+#define SIM_CHECK_SLOT(slot) \
+	if( slot != SIM_SLOT_DEFAULT && (slot < 0 || slot >= _sim_slot_count()) ) \
+	{ \
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER); \
+		return SIM_ERROR_INVALID_PARAMETER; \
+	}
+
+#define SIM_INIT(slot, th) \
+	th = _sim_handle_borrow(slot); \
 	if (!th) { \
 		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED); \
 		return SIM_ERROR_OPERATION_FAILED; \
 	}
 
-#define SIM_MAKE_CB(ccb,th,callback,user_data)  \
-	ccb = (sim_cb_data*) calloc(sizeof(sim_cb_data), 1);\
-	ccb->th = th; \
-	ccb->cb = (void*) callback;\
-	ccb->user_data = user_data
+#define SIM_API_RETURN(stat, call) \
+	int ret = SIM_ERROR_NONE; \
+	SIM_TRACE_API_ENTRY(__func__); \
+	SIM_STATS_BEGIN(begin); \
+	ret = call; \
+	SIM_STATS_END(stat, begin, ret); \
+	SIM_TRACE_API_RETURN(__func__, ret); \
+	return ret
 
-static sim_error_e _convert_access_rt_to_sim_error(TelSimAccessResult_t access_rt)
-{
-	sim_error_e error = SIM_ERROR_NONE;
-	switch (access_rt) {
-		case TAPI_SIM_ACCESS_SUCCESS:
-		case TAPI_SIM_ACCESS_FILE_NOT_FOUND:
-			error = SIM_ERROR_NONE;
-			break;
-		case TAPI_SIM_ACCESS_ACCESS_CONDITION_NOT_SATISFIED:
-		case TAPI_SIM_ACCESS_CARD_ERROR:
-			error = SIM_ERROR_NOT_AVAILABLE;
-			break;
-		case TAPI_SIM_ACCESS_FAILED:
-		default:
-			error = SIM_ERROR_OPERATION_FAILED;
-			break;
-	}
-	return error;
-}
+/* Around libtapi and D-Bus calls, @result is 0 on success */
+#define SIM_IPC_BEGIN(method, var) \
+	SIM_TRACE_IPC_ENTRY(method); \
+	SIM_STATS_BEGIN(var)
 
-int sim_get_icc_id(char** icc_id)
+#define SIM_IPC_END(stat, method, var, result) \
+	SIM_STATS_END(stat, var, (result) == 0 ? SIM_ERROR_NONE : SIM_ERROR_OPERATION_FAILED); \
+	SIM_TRACE_IPC_RETURN(method, result)
+
+static struct tapi_handle *_sim_tel_init(const char *cp_name)
 {
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
 	struct tapi_handle *th = NULL;
-	GError *gerr = NULL;
-	GVariant *sync_gv = NULL;
-	gchar *iccid = NULL;
-	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
-
-	SIM_CHECK_INPUT_PARAMETER(icc_id);
-	SIM_INIT(th);
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*icc_id = NULL;
-	} else {
-		sync_gv = g_dbus_connection_call_sync(th->dbus_connection, DBUS_TELEPHONY_SERVICE, th->path,
-				DBUS_TELEPHONY_SIM_INTERFACE, "GetICCID", NULL, NULL, G_DBUS_CALL_FLAGS_NONE, -1,
-				NULL, &gerr);
+	int ret = 0;
 
-		if (sync_gv) {
-			g_variant_get(sync_gv, "(is)", &result, &iccid);
-			if (result == TAPI_SIM_ACCESS_SUCCESS) {
-				if (iccid != NULL && strlen(iccid) != 0) {
-					*icc_id = (char*) malloc(strlen(iccid) + 1);
-					if (*icc_id == NULL) {
-						LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-						error_code = SIM_ERROR_OUT_OF_MEMORY;
-					} else {
-						snprintf(*icc_id, strlen(iccid) + 1, "%s", iccid);
-					}
-				} else {
-					*icc_id = NULL;
-				}
-			} else {
-				error_code = _convert_access_rt_to_sim_error(result);
-				*icc_id = NULL;
-			}
-		} else {
-			LOGE("g_dbus_conn failed. error (%s)", gerr->message);
-			g_error_free(gerr);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-			*icc_id = NULL;
-		}
-	}
-	tel_deinit(th);
-	return error_code;
+	SIM_IPC_BEGIN("tel_init", begin);
+	th = tel_init(cp_name);
+	ret = th != NULL ? TAPI_API_SUCCESS : -1;
+	SIM_IPC_END(SIM_STAT_TEL_INIT, "tel_init", begin, ret);
+	return th;
 }
 
-int sim_get_mcc(char** mcc)
+static void _sim_tel_deinit(struct tapi_handle *th)
 {
-	TelSimImsiInfo_t sim_imsi_info;
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
-	struct tapi_handle *th = NULL;
-
-	SIM_CHECK_INPUT_PARAMETER(mcc);
-	SIM_INIT(th);
+	int ret = 0;
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*mcc = NULL;
-	} else {
-		if (tel_get_sim_imsi(th, &sim_imsi_info) != 0) {
-			LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-		} else {
-			*mcc = (char*) malloc(sizeof(char) * (3 + 1));
-			if (*mcc == NULL) {
-				LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-				error_code = SIM_ERROR_OUT_OF_MEMORY;
-			} else {
-				snprintf(*mcc, strlen(sim_imsi_info.szMcc) + 1, "%s", sim_imsi_info.szMcc);
-			}
-		}
-	}
-	tel_deinit(th);
-	return error_code;
+	SIM_IPC_BEGIN("tel_deinit", begin);
+	ret = tel_deinit(th);
+	SIM_IPC_END(SIM_STAT_TEL_DEINIT, "tel_deinit", begin, ret);
 }
 
-int sim_get_mnc(char** mnc)
+/* Number of slots, 0 if telephony could not be asked. */
+static int _sim_slot_count(void)
 {
-	TelSimImsiInfo_t sim_imsi_info;
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
-	struct tapi_handle *th = NULL;
+	char **names = g_atomic_pointer_get(&slot_names);
+	int count = 0;
+	int ret = 0;
 
-	SIM_CHECK_INPUT_PARAMETER(mnc);
-	SIM_INIT(th);
+	/* Set once, never freed. */
+	if (names != NULL)
+		return MIN(g_strv_length(names), SIM_SLOT_MAX);
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*mnc = NULL;
-	} else {
-		if (tel_get_sim_imsi(th, &sim_imsi_info) != 0) {
-			LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-		} else {
-			*mnc = (char*) malloc(sizeof(char) * (3 + 1));
-			if (*mnc == NULL) {
-				LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-				error_code = SIM_ERROR_OUT_OF_MEMORY;
-			} else {
-				snprintf(*mnc, strlen(sim_imsi_info.szMnc) + 1, "%s", sim_imsi_info.szMnc);
-			}
-		}
+	G_LOCK(slot_names);
+	if (slot_names == NULL) {
+		SIM_IPC_BEGIN("tel_get_cp_name_list", begin);
+		names = tel_get_cp_name_list();
+		ret = names != NULL ? TAPI_API_SUCCESS : -1;
+		SIM_IPC_END(SIM_STAT_TEL_GET_CP_NAME_LIST, "tel_get_cp_name_list", begin, ret);
+		/* Modems come with the telephony daemon, an empty list is asked
+		 * again next time. */
+		if (names != NULL && names[0] != NULL)
+			g_atomic_pointer_set(&slot_names, names);
+		else
+			g_strfreev(names);
 	}
-
-	tel_deinit(th);
-	return SIM_ERROR_NONE;
+	if (slot_names != NULL)
+		count = MIN(g_strv_length(slot_names), SIM_SLOT_MAX);
+	G_UNLOCK(slot_names);
+	return count;
 }
 
-int sim_get_msin(char** msin)
+/* Modem name to bind @slot to. The default slot keeps tel_init(NULL), so
+ * that it needs no enumeration; slot_names is never freed once set. */
+static const char *_sim_slot_cp_name(sim_slot *slot)
 {
-	TelSimImsiInfo_t sim_imsi_info;
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
-	struct tapi_handle *th = NULL;
+	const char *cp_name = NULL;
 
-	SIM_CHECK_INPUT_PARAMETER(msin);
-	SIM_INIT(th);
+	if (slot->index == SIM_SLOT_DEFAULT)
+		return NULL;
+	G_LOCK(slot_names);
+	cp_name = slot_names[slot->index];
+	G_UNLOCK(slot_names);
+	return cp_name;
+}
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*msin = NULL;
+static void _sim_handle_retire_locked(sim_slot *slot)
+{
+	if (--slot->shared_handle->ref_count == 0) {
+		_sim_tel_deinit(slot->shared_handle->th);
+		free(slot->shared_handle);
 	} else {
-		if (tel_get_sim_imsi(th, &sim_imsi_info) != 0) {
-			LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-		} else {
-			*msin = (char*) malloc(sizeof(char) * (10 + 1));
-			if (*msin == NULL) {
-				LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-				error_code = SIM_ERROR_OUT_OF_MEMORY;
-			} else {
-				snprintf(*msin, strlen(sim_imsi_info.szMsin) + 1, "%s", sim_imsi_info.szMsin);
-			}
-		}
+		slot->retired_handles = g_slist_prepend(slot->retired_handles, slot->shared_handle);
 	}
-	tel_deinit(th);
-	return error_code;
+	g_atomic_pointer_set(&slot->shared_handle, NULL);
 }
 
-int sim_get_spn(char** spn)
+/* Returns the current handle of @slot with a reference for the caller. */
+static sim_handle_ref *_sim_handle_ref_acquire(sim_slot *slot)
 {
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
 	struct tapi_handle *th = NULL;
-	GError *gerr = NULL;
-	GVariant *sync_gv = NULL;
-	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
-	gchar *spn_str = NULL;
-	guchar dc = 0;
-
-	SIM_CHECK_INPUT_PARAMETER(spn);
-	SIM_INIT(th);
+	sim_handle_ref *ref = NULL;
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*spn = NULL;
-	} else {
-		sync_gv = g_dbus_connection_call_sync(th->dbus_connection, DBUS_TELEPHONY_SERVICE, th->path,
-				DBUS_TELEPHONY_SIM_INTERFACE, "GetSpn", NULL, NULL, G_DBUS_CALL_FLAGS_NONE, -1,
-				NULL, &gerr);
+	G_LOCK(shared_handle);
+	if (slot->shared_handle != NULL && g_dbus_connection_is_closed(slot->shared_handle->th->dbus_connection)) {
+		LOGE("[%s] telephony connection closed, rebuilding handle of slot %d", __FUNCTION__, slot->index);
+		_sim_handle_retire_locked(slot);
+	}
 
-		if (sync_gv) {
-			g_variant_get(sync_gv, "(iys)", &result, &dc, &spn_str);
-			if (result == TAPI_SIM_ACCESS_SUCCESS) {
-				if (spn_str != NULL && strlen(spn_str) != 0) {
-					*spn = (char*) malloc(strlen(spn_str) + 1);
-					if (*spn == NULL) {
-						LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-						error_code = SIM_ERROR_OUT_OF_MEMORY;
-					} else {
-						snprintf(*spn, strlen(spn_str) + 1, "%s", spn_str);
-					}
-				} else {
-					*spn = NULL;
-				}
-			} else {
-				error_code = _convert_access_rt_to_sim_error(result);
-				*spn = NULL;
+	if (slot->shared_handle == NULL) {
+		th = _sim_tel_init(_sim_slot_cp_name(slot));
+		if (th != NULL) {
+			ref = (sim_handle_ref*) calloc(sizeof(sim_handle_ref), 1);
+			if (ref == NULL) {
+				_sim_tel_deinit(th);
+				G_UNLOCK(shared_handle);
+				return NULL;
 			}
-		} else {
-			LOGE("g_dbus_conn failed. error (%s)", gerr->message);
-			g_error_free(gerr);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-			*spn = NULL;
+			ref->th = th;
+			ref->ref_count = 1;
+			g_atomic_pointer_set(&slot->shared_handle, ref);
 		}
 	}
-	tel_deinit(th);
-	return error_code;
+
+	ref = slot->shared_handle;
+	if (ref != NULL)
+		ref->ref_count++;
+	G_UNLOCK(shared_handle);
+	return ref;
 }
 
-int sim_get_cphs_operator_name(char** full_name, char** short_name)
+/* For holders which outlive the call, such as pending async requests and
+ * the status subscription; must be paired with _sim_handle_release(). */
+static struct tapi_handle *_sim_handle_acquire(sim_slot *slot)
 {
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
-	struct tapi_handle *th = NULL;
-	GError *gerr = NULL;
-	GVariant *sync_gv = NULL;
-	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
-	gchar *full_str = NULL;
-	gchar *short_str = NULL;
+	sim_handle_ref *ref = _sim_handle_ref_acquire(slot);
 
-	SIM_CHECK_INPUT_PARAMETER(full_name);
-	SIM_CHECK_INPUT_PARAMETER(short_name);
-	SIM_INIT(th);
+	return ref != NULL ? ref->th : NULL;
+}
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*full_name = NULL;
-		*short_name = NULL;
-	} else {
-		sync_gv = g_dbus_connection_call_sync(th->dbus_connection, DBUS_TELEPHONY_SERVICE, th->path,
-				DBUS_TELEPHONY_SIM_INTERFACE, "GetCphsNetName", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
-				-1, NULL, &gerr);
+static void _sim_handle_release(sim_slot *slot, struct tapi_handle *th)
+{
+	GSList *l = NULL;
+	sim_handle_ref *ref = NULL;
 
-		if (sync_gv) {
-			g_variant_get(sync_gv, "(iss)", &result, &full_str, &short_str);
-			if (result == TAPI_SIM_ACCESS_SUCCESS) {
-				if (full_str != NULL && strlen(full_str) != 0) {
-					*full_name = (char*) malloc(strlen(full_str) + 1);
-					if (*full_name == NULL) {
-						LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-						error_code = SIM_ERROR_OUT_OF_MEMORY;
-					} else {
-						snprintf(*full_name, strlen(full_str) + 1, "%s", full_str);
-					}
-				} else {
-					*full_name = NULL;
-				}
-
-				if (short_str != NULL && strlen(short_str) != 0) {
-					*short_name = (char*) malloc(strlen(short_str) + 1);
-					if (*short_name == NULL) {
-						LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-						error_code = SIM_ERROR_OUT_OF_MEMORY;
-					} else {
-						snprintf(*short_name, strlen(short_str) + 1, "%s", short_str);
-					}
-				} else {
-					*short_name = NULL;
-				}
-			} else {
-				error_code = _convert_access_rt_to_sim_error(result);
-				*full_name = NULL;
-				*short_name = NULL;
+	G_LOCK(shared_handle);
+	if (slot->shared_handle != NULL && slot->shared_handle->th == th) {
+		slot->shared_handle->ref_count--;
+	} else {
+		for (l = slot->retired_handles; l != NULL; l = l->next) {
+			ref = l->data;
+			if (ref->th != th)
+				continue;
+			if (--ref->ref_count == 0) {
+				slot->retired_handles = g_slist_remove(slot->retired_handles, ref);
+				_sim_tel_deinit(ref->th);
+				free(ref);
 			}
-		} else {
-			LOGE("g_dbus_conn failed. error (%s)", gerr->message);
-			g_error_free(gerr);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-			*full_name = NULL;
-			*short_name = NULL;
+			break;
 		}
 	}
-	tel_deinit(th);
-	return error_code;
+	G_UNLOCK(shared_handle);
 }
 
-int sim_get_state(sim_state_e* sim_state)
+static void _sim_thread_handles_free(gpointer data)
 {
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
-	int error_code = SIM_ERROR_NONE;
-	struct tapi_handle *th = NULL;
-
-	SIM_CHECK_INPUT_PARAMETER(sim_state);
-	SIM_INIT(th);
+	sim_thread_handles *cached = data;
+	int i = 0;
 
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0) {
-		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
-		error_code = SIM_ERROR_OPERATION_FAILED;
-	} else {
-		switch (sim_card_state) {
-			case TAPI_SIM_STATUS_CARD_ERROR:
-				*sim_state = SIM_STATE_UNAVAILABLE;
-				break;
-			case TAPI_SIM_STATUS_CARD_NOT_PRESENT:
-				*sim_state = SIM_STATE_UNAVAILABLE;
-				break;
-			case TAPI_SIM_STATUS_SIM_INITIALIZING:
-				*sim_state = SIM_STATE_UNKNOWN;
-				break;
-			case TAPI_SIM_STATUS_SIM_INIT_COMPLETED:
-				*sim_state = SIM_STATE_AVAILABLE;
-				break;
-			case TAPI_SIM_STATUS_SIM_PIN_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			case TAPI_SIM_STATUS_SIM_PUK_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			case TAPI_SIM_STATUS_CARD_BLOCKED:
-				*sim_state = SIM_STATE_UNAVAILABLE;
-				break;
-			case TAPI_SIM_STATUS_SIM_NCK_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			case TAPI_SIM_STATUS_SIM_NSCK_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			case TAPI_SIM_STATUS_SIM_SPCK_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			case TAPI_SIM_STATUS_SIM_CCK_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			case TAPI_SIM_STATUS_CARD_REMOVED:
-				*sim_state = SIM_STATE_UNAVAILABLE;
-				break;
-			case TAPI_SIM_STATUS_SIM_LOCK_REQUIRED:
-				*sim_state = SIM_STATE_LOCKED;
-				break;
-			default:
-				*sim_state = SIM_STATE_UNAVAILABLE;
-				break;
-		}
+	for (i = 0; i < SIM_SLOT_MAX; i++) {
+		if (cached->refs[i] != NULL)
+			_sim_handle_release(&slots[i], cached->refs[i]->th);
 	}
-
-	tel_deinit(th);
-	return error_code;
+	free(cached);
 }
 
-int sim_get_subscriber_number(char** subscriber_number)
+/* Handle for the duration of a synchronous call on this thread, nothing to
+ * release. The thread keeps its own reference between calls, so as long as
+ * the handle of the slot is unchanged and connected no lock is taken.
+ * Handles share the D-Bus connection of libtapi, where concurrent calls
+ * from several threads do not wait for each other's replies. */
+static struct tapi_handle *_sim_handle_borrow(sim_slot *slot)
 {
-	int error_code = SIM_ERROR_NONE;
-	int card_changed = 0;
-	TelSimCardStatus_t sim_card_state = 0x00;
-	struct tapi_handle *th = NULL;
-	GError *gerr = NULL;
-	GVariant *sync_gv = NULL;
-	GVariant *value = NULL;
-	GVariantIter *iter = NULL;
-	GVariantIter *iter_row = NULL;
-	const gchar *key = NULL;
-	const gchar *str_value = NULL;
-	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
-	TelSimMsisdnList_t list;
-	int i = 0;
+	sim_thread_handles *cached = g_private_get(&thread_handles);
+	sim_handle_ref *ref = NULL;
 
-	SIM_CHECK_INPUT_PARAMETER(subscriber_number);
-	SIM_INIT(th);
-
-	if (tel_get_sim_init_info(th, &sim_card_state, &card_changed) != 0 || sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
-		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
-		error_code = SIM_ERROR_NOT_AVAILABLE;
-		*subscriber_number = NULL;
-	} else {
-		sync_gv = g_dbus_connection_call_sync(th->dbus_connection, DBUS_TELEPHONY_SERVICE, th->path,
-				DBUS_TELEPHONY_SIM_INTERFACE, "GetMSISDN", NULL, NULL, G_DBUS_CALL_FLAGS_NONE, -1,
-				NULL, &gerr);
+	if (cached == NULL) {
+		cached = (sim_thread_handles*) calloc(sizeof(sim_thread_handles), 1);
+		if (cached == NULL)
+			return NULL;
+		g_private_set(&thread_handles, cached);
+	}
 
-		if (sync_gv) {
-			memset(&list, 0, sizeof(TelSimMsisdnList_t));
-			g_variant_get(sync_gv, "(iaa{sv})", &result, &iter);
-			list.count = g_variant_iter_n_children(iter);
+	ref = cached->refs[slot->index];
+	if (ref != NULL && ref == g_atomic_pointer_get(&slot->shared_handle)
+			&& !g_dbus_connection_is_closed(ref->th->dbus_connection))
+		return ref->th;
 
-			if (result == TAPI_SIM_ACCESS_SUCCESS) {
-				i = 0;
-				while (g_variant_iter_next(iter, "a{sv}", &iter_row)) {
-					while (g_variant_iter_loop(iter_row, "{sv}", &key, &value)) {
-						if (!g_strcmp0(key, "name")) {
-							str_value = g_variant_get_string(value, NULL);
-							snprintf(list.list[i].name, strlen(str_value) + 1, "%s", str_value);
-						}
-						if (!g_strcmp0(key, "number")) {
-							str_value = g_variant_get_string(value, NULL);
-							snprintf(list.list[i].num, strlen(str_value) + 1, "%s", str_value);
-						}
-					}
-					i++;
-					g_variant_iter_free(iter_row);
-				}
-				g_variant_iter_free(iter);
-
-				if (list.list[0].num != NULL && strlen(list.list[0].num) != 0) {
-					*subscriber_number = (char*) malloc(strlen(list.list[0].num) + 1);
-					if (*subscriber_number == NULL) {
-						LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
-						error_code = SIM_ERROR_OUT_OF_MEMORY;
-					} else {
-						snprintf(*subscriber_number, strlen(list.list[0].num) + 1, "%s",
-								list.list[0].num);
-					}
-				} else {
-					*subscriber_number = NULL;
-				}
-
-			} else {
-				error_code = _convert_access_rt_to_sim_error(result);
-				*subscriber_number = NULL;
-			}
-		} else {
-			LOGE("g_dbus_conn failed. error (%s)", gerr->message);
-			g_error_free(gerr);
-			error_code = SIM_ERROR_OPERATION_FAILED;
-			*subscriber_number = NULL;
-		}
-	}
-	tel_deinit(th);
-	return error_code;
+	ref = _sim_handle_ref_acquire(slot);
+	if (ref == NULL)
+		return NULL;
+	if (cached->refs[slot->index] != NULL)
+		_sim_handle_release(slot, cached->refs[slot->index]->th);
+	cached->refs[slot->index] = ref;
+	return ref->th;
 }
 
-static void on_noti_sim_status(struct tapi_handle *handle, const char *noti_id, void *data,
-		void *user_data)
+static sim_error_e _convert_access_rt_to_sim_error(TelSimAccessResult_t access_rt)
 {
-	TelSimCardStatus_t *status = data;
-	sim_cb_data *ccb = user_data;
-	sim_state_e state = SIM_STATE_UNKNOWN;
-	sim_state_changed_cb cb;
-	LOGE("event(%s) receive with status[%d]", TAPI_NOTI_SIM_STATUS, *status);
-
-	switch (*status) {
-		case TAPI_SIM_STATUS_CARD_ERROR:
-			state = SIM_STATE_UNAVAILABLE;
-			break;
-		case TAPI_SIM_STATUS_CARD_NOT_PRESENT:
-			state = SIM_STATE_UNAVAILABLE;
-			break;
-		case TAPI_SIM_STATUS_SIM_INITIALIZING:
-			state = SIM_STATE_UNKNOWN;
-			break;
-		case TAPI_SIM_STATUS_SIM_INIT_COMPLETED:
-			state = SIM_STATE_AVAILABLE;
-			break;
-		case TAPI_SIM_STATUS_SIM_PIN_REQUIRED:
-			state = SIM_STATE_LOCKED;
-			break;
-		case TAPI_SIM_STATUS_SIM_PUK_REQUIRED:
-			state = SIM_STATE_LOCKED;
-			break;
-		case TAPI_SIM_STATUS_CARD_BLOCKED:
-			state = SIM_STATE_UNAVAILABLE;
-			break;
-		case TAPI_SIM_STATUS_SIM_NCK_REQUIRED:
-			state = SIM_STATE_LOCKED;
-			break;
-		case TAPI_SIM_STATUS_SIM_NSCK_REQUIRED:
-			state = SIM_STATE_LOCKED;
-			break;
-		case TAPI_SIM_STATUS_SIM_SPCK_REQUIRED:
-			state = SIM_STATE_LOCKED;
-			break;
-		case TAPI_SIM_STATUS_SIM_CCK_REQUIRED:
-			state = SIM_STATE_LOCKED;
-			break;
-		case TAPI_SIM_STATUS_CARD_REMOVED:
-			state = SIM_STATE_UNAVAILABLE;
+	sim_error_e error = SIM_ERROR_NONE;
+	switch (access_rt) {
+		case TAPI_SIM_ACCESS_SUCCESS:
+		case TAPI_SIM_ACCESS_FILE_NOT_FOUND:
+			error = SIM_ERROR_NONE;
 			break;
-		case TAPI_SIM_STATUS_SIM_LOCK_REQUIRED:
-			state = SIM_STATE_LOCKED;
+		case TAPI_SIM_ACCESS_ACCESS_CONDITION_NOT_SATISFIED:
+		case TAPI_SIM_ACCESS_CARD_ERROR:
+			error = SIM_ERROR_NOT_AVAILABLE;
 			break;
+		case TAPI_SIM_ACCESS_FAILED:
 		default:
-			state = SIM_STATE_UNAVAILABLE;
+			error = SIM_ERROR_OPERATION_FAILED;
 			break;
 	}
-	if (!ccb->cb) {
-		LOGE("[%s] callback is null", __FUNCTION__);
-		return;
-	}
-	cb = ccb->cb;
-	cb(state, ccb->user_data);
+	return error;
 }
 
-int sim_set_state_changed_cb(sim_state_changed_cb sim_cb, void* user_data)
+static sim_state_e _convert_card_status_to_sim_state(TelSimCardStatus_t sim_card_state)
 {
-	int error_code = SIM_ERROR_NONE;
-	int ret;
-	sim_cb_data *ccb = NULL;
+	if ((unsigned int) sim_card_state >= G_N_ELEMENTS(sim_state_table))
+		return SIM_STATE_UNAVAILABLE;
+	return sim_state_table[sim_card_state];
+}
 
-	SIM_CHECK_INPUT_PARAMETER(sim_cb);
+/* A notification always wins; a state read with sim_get_state() is only
+ * stored if no notification has arrived since the subscription started. */
+static void _sim_state_mirror_update(sim_slot *slot, sim_state_e state, gboolean notified)
+{
+	gint old = 0;
 
-	ghandle = tel_init(NULL);
-	if (!ghandle) {
-		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
-		return SIM_ERROR_OPERATION_FAILED;
-	}
+	do {
+		old = g_atomic_int_get(&slot->state_mirror);
+		if (old == SIM_MIRROR_UNWATCHED || (!notified && old != SIM_MIRROR_UNKNOWN))
+			return;
+	} while (!g_atomic_int_compare_and_exchange(&slot->state_mirror, old, state));
+}
 
-	ccb = (sim_cb_data*) calloc(sizeof(sim_cb_data), 1);
-	ccb->th = ghandle;
-	ccb->cb = (void*) sim_cb;
-	ccb->user_data = user_data;
+static int _sim_copy_string(const char *src, char **dest)
+{
+	*dest = (char*) malloc(strlen(src) + 1);
+	if (*dest == NULL) {
+		LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+		return SIM_ERROR_OUT_OF_MEMORY;
+	}
+	snprintf(*dest, strlen(src) + 1, "%s", src);
+	return SIM_ERROR_NONE;
+}
 
-	ret = tel_register_noti_event(ghandle, TAPI_NOTI_SIM_STATUS, on_noti_sim_status, ccb);
-	if (ret != TAPI_API_SUCCESS) error_code = SIM_ERROR_OPERATION_FAILED;
-	return error_code;
+/* Values that are not stored in SIM card are returned as NULL. */
+static int _sim_copy_optional_string(const char *src, char **dest)
+{
+	if (src == NULL || strlen(src) == 0) {
+		*dest = NULL;
+		return SIM_ERROR_NONE;
+	}
+	return _sim_copy_string(src, dest);
 }
 
-int sim_unset_state_changed_cb()
+static gchar *_sim_dup_optional_string(const gchar *src)
+{
+	return (src != NULL && strlen(src) != 0) ? g_strdup(src) : NULL;
+}
+
+static void _sim_value_copy(const sim_value *src, sim_value *dest)
+{
+	dest->str[0] = g_strdup(src->str[0]);
+	dest->str[1] = g_strdup(src->str[1]);
+	memcpy(&dest->imsi, &src->imsi, sizeof(sim_imsi_info_s));
+	dest->list = src->list != NULL ? g_variant_ref(src->list) : NULL;
+}
+
+static void _sim_value_clear(sim_value *value)
+{
+	g_free(value->str[0]);
+	g_free(value->str[1]);
+	if (value->list != NULL)
+		g_variant_unref(value->list);
+	memset(value, 0, sizeof(sim_value));
+}
+
+static void _sim_cache_invalidate_locked(sim_cache *cache)
+{
+	int i = 0;
+
+	cache->generation++;
+	cache->valid = 0;
+	for (i = 0; i < SIM_FIELD_MAX; i++)
+		_sim_value_clear(&cache->values[i]);
+}
+
+static void _sim_cache_invalidate(sim_slot *slot)
+{
+	g_rw_lock_writer_lock(&slot->cache_lock);
+	_sim_cache_invalidate_locked(&slot->cache);
+	g_rw_lock_writer_unlock(&slot->cache_lock);
+}
+
+/* Once init has completed, card_changed tells whether the record of the
+ * identity cache file still describes the inserted card. A card_changed
+ * already set does not change when that card is swapped for another one,
+ * so without a status subscription it is taken as a new card every time. */
+static void _sim_persist_check_card(sim_slot *slot, TelSimCardStatus_t sim_card_state, int card_changed)
+{
+	if (sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
+		g_atomic_int_set(&slot->persist_state, SIM_PERSIST_UNCHECKED);
+		return;
+	}
+	if (g_atomic_int_get(&slot->persist_state) != SIM_PERSIST_UNCHECKED
+			&& (!card_changed || g_atomic_int_get(&slot->status_watched)))
+		return;
+	if (card_changed)
+		_sim_persist_forget(slot->index);
+	g_atomic_int_set(&slot->persist_state, card_changed ? SIM_PERSIST_REPLACING : SIM_PERSIST_VERIFIED);
+}
+
+/* Validates the cache against the SIM init state reported by telephony and
+ * returns the cache generation the caller may fill. A card_changed value
+ * different from the one seen when the cache was filled means another card
+ * is inserted now. A set one cannot tell two new cards apart, so without a
+ * status subscription the values of an earlier call are dropped then. */
+static int _sim_cache_check_card(sim_slot *slot, TelSimCardStatus_t sim_card_state, int card_changed,
+		unsigned int *generation)
+{
+	sim_cache *cache = &slot->cache;
+
+	_sim_persist_check_card(slot, sim_card_state, card_changed);
+	if (sim_card_state != TAPI_SIM_STATUS_SIM_INIT_COMPLETED) {
+		_sim_cache_invalidate(slot);
+		return SIM_ERROR_NOT_AVAILABLE;
+	}
+
+	g_rw_lock_writer_lock(&slot->cache_lock);
+	if (cache->valid != 0 && (cache->card_changed != card_changed
+			|| (card_changed && !g_atomic_int_get(&slot->status_watched))))
+		_sim_cache_invalidate_locked(cache);
+	cache->card_changed = card_changed;
+	*generation = cache->generation;
+	g_rw_lock_writer_unlock(&slot->cache_lock);
+	return SIM_ERROR_NONE;
+}
+
+/* @timeout_ms is SIM_TIMEOUT_DEFAULT for the library-wide timeout. */
+static void _sim_call_ctx_init(sim_call_ctx *ctx, int timeout_ms, sim_cancellable_h cancellable)
+{
+	if (timeout_ms == SIM_TIMEOUT_DEFAULT)
+		timeout_ms = g_atomic_int_get(&call_timeout);
+	ctx->deadline = timeout_ms > 0 ? g_get_monotonic_time() + timeout_ms * G_TIME_SPAN_MILLISECOND : 0;
+	ctx->cancellable = cancellable != NULL ? cancellable->cancellable : NULL;
+}
+
+/* Timeout of the next request of @ctx: -1 for the D-Bus default, 0 once
+ * the deadline has passed. */
+static int _sim_call_ctx_timeout(const sim_call_ctx *ctx)
+{
+	gint64 left = 0;
+
+	if (ctx->deadline == 0)
+		return -1;
+	left = (ctx->deadline - g_get_monotonic_time() + G_TIME_SPAN_MILLISECOND - 1) / G_TIME_SPAN_MILLISECOND;
+	return left > 0 ? (int) MIN(left, G_MAXINT) : 0;
+}
+
+static int _convert_gerror_to_sim_error(const GError *gerr)
+{
+	if (g_error_matches(gerr, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)
+			|| g_error_matches(gerr, G_DBUS_ERROR, G_DBUS_ERROR_NO_REPLY)
+			|| g_error_matches(gerr, G_DBUS_ERROR, G_DBUS_ERROR_TIMEOUT)
+			|| g_error_matches(gerr, G_DBUS_ERROR, G_DBUS_ERROR_TIMED_OUT))
+		return SIM_ERROR_TIMED_OUT;
+	if (g_error_matches(gerr, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+		return SIM_ERROR_CANCELED;
+	return SIM_ERROR_OPERATION_FAILED;
+}
+
+/* Calls @method of the Sim interface within the bounds of @ctx. On failure
+ * returns NULL and sets @error_code. */
+static GVariant *_sim_call_sync(struct tapi_handle *th, const char *method, sim_stat_e stat,
+		const sim_call_ctx *ctx, int *error_code)
 {
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	int timeout = _sim_call_ctx_timeout(ctx);
+	int ret = 0;
+
+	if (timeout == 0) {
+		LOGE("[%s] %s TIMED_OUT(0x%08x)", __FUNCTION__, method, SIM_ERROR_TIMED_OUT);
+		*error_code = SIM_ERROR_TIMED_OUT;
+		return NULL;
+	}
+
+	SIM_IPC_BEGIN(method, begin);
+	reply = g_dbus_connection_call_sync(th->dbus_connection, DBUS_TELEPHONY_SERVICE, th->path,
+			DBUS_TELEPHONY_SIM_INTERFACE, method, NULL, NULL, G_DBUS_CALL_FLAGS_NONE, timeout,
+			ctx->cancellable, &gerr);
+	ret = reply != NULL ? 0 : -1;
+	SIM_IPC_END(stat, method, begin, ret);
+
+	if (reply == NULL) {
+		*error_code = _convert_gerror_to_sim_error(gerr);
+		LOGE("[%s] %s failed(0x%08x): %s", __FUNCTION__, method, *error_code, gerr->message);
+		g_error_free(gerr);
+	}
+	return reply;
+}
+
+/* tel_get_sim_init_info() cannot be bounded, so its request is sent here. */
+static int _sim_get_init_status(struct tapi_handle *th, const sim_call_ctx *ctx,
+		TelSimCardStatus_t *sim_card_state, gboolean *card_changed)
+{
+	int error_code = SIM_ERROR_NONE;
+	GVariant *reply = NULL;
+
+	reply = _sim_call_sync(th, "GetInitStatus", SIM_STAT_DBUS_GET_INIT_STATUS, ctx, &error_code);
+	if (reply == NULL)
+		return error_code;
+	g_variant_get(reply, "(ib)", sim_card_state, card_changed);
+	g_variant_unref(reply);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_check_init(sim_slot *slot, struct tapi_handle *th, const sim_call_ctx *ctx,
+		unsigned int *generation)
+{
+	gboolean card_changed = FALSE;
+	TelSimCardStatus_t sim_card_state = 0x00;
 	int error_code = SIM_ERROR_NONE;
-	int ret;
 
-	if (ghandle == NULL) {
-		ghandle = tel_init(NULL);
-		if (!ghandle) {
-			LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+	error_code = _sim_get_init_status(th, ctx, &sim_card_state, &card_changed);
+	if (error_code == SIM_ERROR_TIMED_OUT || error_code == SIM_ERROR_CANCELED)
+		return error_code;
+	if (error_code != SIM_ERROR_NONE) {
+		_sim_cache_invalidate(slot);
+		return SIM_ERROR_NOT_AVAILABLE;
+	}
+	return _sim_cache_check_card(slot, sim_card_state, card_changed, generation);
+}
+
+/* Without a status subscription nothing tells us about a card swap, so the
+ * cache is only trusted once the init state has been checked (@checked). */
+static gboolean _sim_cache_get_value(sim_slot *slot, sim_field_e field, sim_value *value, gboolean checked)
+{
+	gboolean hit = FALSE;
+
+	if (!checked && !g_atomic_int_get(&slot->status_watched))
+		return FALSE;
+
+	g_rw_lock_reader_lock(&slot->cache_lock);
+	if (slot->cache.valid & SIM_FIELD_BIT(field)) {
+		_sim_value_copy(&slot->cache.values[field], value);
+		hit = TRUE;
+	}
+	g_rw_lock_reader_unlock(&slot->cache_lock);
+	return hit;
+}
+
+static unsigned int _sim_cache_generation(sim_slot *slot)
+{
+	unsigned int generation = 0;
+
+	g_rw_lock_reader_lock(&slot->cache_lock);
+	generation = slot->cache.generation;
+	g_rw_lock_reader_unlock(&slot->cache_lock);
+	return generation;
+}
+
+static void _sim_cache_set_value(sim_slot *slot, unsigned int generation, sim_field_e field,
+		const sim_value *value)
+{
+	sim_cache *cache = &slot->cache;
+	gboolean stored = FALSE;
+
+	g_rw_lock_writer_lock(&slot->cache_lock);
+	if (cache->generation == generation && !(cache->valid & SIM_FIELD_BIT(field))) {
+		_sim_value_copy(value, &cache->values[field]);
+		cache->valid |= SIM_FIELD_BIT(field);
+		stored = TRUE;
+	}
+	g_rw_lock_writer_unlock(&slot->cache_lock);
+
+	if (stored)
+		_sim_persist_store(slot->index, (sim_persist_field_e) field, value->str[0], value->str[1], &value->imsi);
+}
+
+static TelSimAccessResult_t _sim_parse_msisdn(GVariant *reply, sim_value *value)
+{
+	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
+	GVariant *rows = NULL;
+	GVariant *row = NULL;
+	const gchar *str_value = NULL;
+
+	g_variant_get(reply, "(i@aa{sv})", &result, &rows);
+	if (result != TAPI_SIM_ACCESS_SUCCESS) {
+		g_variant_unref(rows);
+		return result;
+	}
+
+	if (g_variant_n_children(rows) > 0) {
+		row = g_variant_get_child_value(rows, 0);
+		if (g_variant_lookup(row, "number", "&s", &str_value))
+			value->str[0] = _sim_dup_optional_string(str_value);
+		g_variant_unref(row);
+	}
+	value->list = rows;
+	return result;
+}
+
+static int _sim_parse_value(sim_field_e field, GVariant *reply, sim_value *value)
+{
+	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
+	const gchar *str[3] = { NULL, NULL, NULL };
+	guchar dc = 0;
+
+	switch (field) {
+		case SIM_FIELD_ICC_ID:
+			g_variant_get(reply, "(i&s)", &result, &str[0]);
+			break;
+		case SIM_FIELD_IMSI:
+			/* Same reply tel_get_sim_imsi() parses. */
+			g_variant_get(reply, "(i&s&s&s)", &result, &str[0], &str[1], &str[2]);
+			if (result == TAPI_SIM_ACCESS_SUCCESS) {
+				snprintf(value->imsi.mcc, sizeof(value->imsi.mcc), "%s", str[0]);
+				snprintf(value->imsi.mnc, sizeof(value->imsi.mnc), "%s", str[1]);
+				snprintf(value->imsi.msin, sizeof(value->imsi.msin), "%s", str[2]);
+			}
+			return _convert_access_rt_to_sim_error(result);
+		case SIM_FIELD_SPN:
+			g_variant_get(reply, "(iy&s)", &result, &dc, &str[0]);
+			break;
+		case SIM_FIELD_CPHS:
+			g_variant_get(reply, "(i&s&s)", &result, &str[0], &str[1]);
+			break;
+		case SIM_FIELD_MSISDN:
+			return _convert_access_rt_to_sim_error(_sim_parse_msisdn(reply, value));
+		default:
 			return SIM_ERROR_OPERATION_FAILED;
+	}
+
+	if (result == TAPI_SIM_ACCESS_SUCCESS) {
+		value->str[0] = _sim_dup_optional_string(str[0]);
+		value->str[1] = _sim_dup_optional_string(str[1]);
+	}
+	return _convert_access_rt_to_sim_error(result);
+}
+
+/* Sends the request without asking for the init state first, which is only
+ * done once the request has failed: SIM card which is not initialized makes
+ * it NOT_AVAILABLE. The value is only cached if a status subscription will
+ * tell about a card swap, as the card has not been checked. */
+static int _sim_get_value_optimistic(sim_slot *slot, struct tapi_handle *th, sim_field_e field,
+		sim_value *value, const sim_call_ctx *ctx)
+{
+	int error_code = SIM_ERROR_NONE;
+	int init_error = SIM_ERROR_NONE;
+	unsigned int generation = _sim_cache_generation(slot);
+	GVariant *sync_gv = NULL;
+
+	sync_gv = _sim_call_sync(th, sim_field_method[field], SIM_STAT_DBUS(field), ctx, &error_code);
+	if (sync_gv) {
+		error_code = _sim_parse_value(field, sync_gv, value);
+		g_variant_unref(sync_gv);
+	}
+	if (error_code == SIM_ERROR_NONE) {
+		if (g_atomic_int_get(&slot->status_watched))
+			_sim_cache_set_value(slot, generation, field, value);
+		return SIM_ERROR_NONE;
+	}
+
+	_sim_value_clear(value);
+	if (error_code == SIM_ERROR_TIMED_OUT || error_code == SIM_ERROR_CANCELED)
+		return error_code;
+	init_error = _sim_check_init(slot, th, ctx, &generation);
+	LOGE("[%s] failed(0x%08x), init state (0x%08x)", __FUNCTION__, error_code, init_error);
+	return init_error != SIM_ERROR_NONE ? init_error : error_code;
+}
+
+static int _sim_get_value_uncached(sim_slot *slot, struct tapi_handle *th, sim_field_e field, sim_value *value,
+		const sim_call_ctx *ctx)
+{
+	int error_code = SIM_ERROR_NONE;
+	unsigned int generation = 0;
+	GVariant *sync_gv = NULL;
+
+	if (g_atomic_int_get(&optimistic_mode))
+		return _sim_get_value_optimistic(slot, th, field, value, ctx);
+
+	error_code = _sim_check_init(slot, th, ctx, &generation);
+	if (error_code != SIM_ERROR_NONE) {
+		LOGE("[%s] failed(0x%08x)", __FUNCTION__, error_code);
+	} else if (_sim_cache_get_value(slot, field, value, TRUE)) {
+		error_code = SIM_ERROR_NONE;
+	} else {
+		/* GetIMSI is parsed here too, tel_get_sim_imsi() cannot be bounded. */
+		sync_gv = _sim_call_sync(th, sim_field_method[field], SIM_STAT_DBUS(field), ctx, &error_code);
+		if (sync_gv) {
+			error_code = _sim_parse_value(field, sync_gv, value);
+			if (error_code == SIM_ERROR_NONE)
+				_sim_cache_set_value(slot, generation, field, value);
+			g_variant_unref(sync_gv);
+		}
+	}
+	return error_code;
+}
+
+static void _sim_flight_unref_locked(sim_flight *flight)
+{
+	if (--flight->ref_count > 0)
+		return;
+	_sim_value_clear(&flight->value);
+	free(flight);
+}
+
+static void _sim_flight_wake(GCancellable *cancellable, gpointer user_data)
+{
+	sim_slot *slot = user_data;
+
+	g_mutex_lock(&slot->flight_lock);
+	g_cond_broadcast(&slot->flight_done);
+	g_mutex_unlock(&slot->flight_lock);
+}
+
+/* Waits for @flight within the bounds of @ctx and takes its result. Drops
+ * the reference the caller took. */
+static int _sim_flight_wait(sim_slot *slot, sim_flight *flight, sim_value *value, const sim_call_ctx *ctx)
+{
+	int error_code = SIM_ERROR_NONE;
+	gulong handler = 0;
+
+	if (ctx->cancellable != NULL)
+		handler = g_cancellable_connect(ctx->cancellable, G_CALLBACK(_sim_flight_wake), slot, NULL);
+
+	g_mutex_lock(&slot->flight_lock);
+	while (!flight->done && error_code == SIM_ERROR_NONE) {
+		if (g_cancellable_is_cancelled(ctx->cancellable))
+			error_code = SIM_ERROR_CANCELED;
+		else if (ctx->deadline == 0)
+			g_cond_wait(&slot->flight_done, &slot->flight_lock);
+		else if (!g_cond_wait_until(&slot->flight_done, &slot->flight_lock, ctx->deadline) && !flight->done)
+			error_code = SIM_ERROR_TIMED_OUT;
+	}
+	if (error_code == SIM_ERROR_NONE) {
+		error_code = flight->error_code;
+		if (error_code == SIM_ERROR_NONE)
+			_sim_value_copy(&flight->value, value);
+	}
+	_sim_flight_unref_locked(flight);
+	g_mutex_unlock(&slot->flight_lock);
+
+	if (handler != 0)
+		g_cancellable_disconnect(ctx->cancellable, handler);
+	return error_code;
+}
+
+/* Whether the failure of a leader is its own rather than about SIM card:
+ * it was canceled, or gave up earlier than the follower would have. */
+static gboolean _sim_flight_failed_early(int error_code, gint64 leader_deadline, const sim_call_ctx *ctx)
+{
+	if (error_code == SIM_ERROR_CANCELED)
+		return TRUE;
+	return error_code == SIM_ERROR_TIMED_OUT && leader_deadline != 0
+			&& (ctx->deadline == 0 || ctx->deadline > leader_deadline);
+}
+
+/* Concurrent readers of one field share a single request: the first one
+ * sends it and the others wait for its reply instead of sending their own,
+ * so a card becoming ready is not met by a burst of identical requests. A
+ * follower whose leader failed early tries again. */
+static int _sim_get_value_shared(sim_slot *slot, struct tapi_handle *th, sim_field_e field, sim_value *value,
+		const sim_call_ctx *ctx)
+{
+	int error_code = SIM_ERROR_NONE;
+	gint64 leader_deadline = 0;
+	sim_flight *flight = NULL;
+
+	for (;;) {
+		g_mutex_lock(&slot->flight_lock);
+		flight = slot->flights[field];
+		if (flight == NULL)
+			break;
+		flight->ref_count++;
+		leader_deadline = flight->deadline;
+		g_mutex_unlock(&slot->flight_lock);
+
+		error_code = _sim_flight_wait(slot, flight, value, ctx);
+		if (!_sim_flight_failed_early(error_code, leader_deadline, ctx)
+				|| g_cancellable_is_cancelled(ctx->cancellable))
+			return error_code;
+	}
+
+	flight = (sim_flight*) calloc(sizeof(sim_flight), 1);
+	if (flight == NULL) {
+		g_mutex_unlock(&slot->flight_lock);
+		return _sim_get_value_uncached(slot, th, field, value, ctx);
+	}
+	flight->ref_count = 1;
+	flight->deadline = ctx->deadline;
+	slot->flights[field] = flight;
+	g_mutex_unlock(&slot->flight_lock);
+
+	error_code = _sim_get_value_uncached(slot, th, field, value, ctx);
+
+	g_mutex_lock(&slot->flight_lock);
+	flight->error_code = error_code;
+	if (error_code == SIM_ERROR_NONE && flight->ref_count > 1)
+		_sim_value_copy(value, &flight->value);
+	flight->done = TRUE;
+	slot->flights[field] = NULL;
+	_sim_flight_unref_locked(flight);
+	g_cond_broadcast(&slot->flight_done);
+	g_mutex_unlock(&slot->flight_lock);
+	return error_code;
+}
+
+/* @ctx is NULL for the library-wide timeout and no cancellation. */
+static int _sim_get_value(sim_slot *slot, sim_field_e field, sim_value *value, const sim_call_ctx *ctx)
+{
+	struct tapi_handle *th = NULL;
+	sim_call_ctx defaults;
+
+	memset(value, 0, sizeof(sim_value));
+	if (_sim_cache_get_value(slot, field, value, FALSE))
+		return SIM_ERROR_NONE;
+	if (ctx == NULL) {
+		_sim_call_ctx_init(&defaults, SIM_TIMEOUT_DEFAULT, NULL);
+		ctx = &defaults;
+	}
+	SIM_INIT(slot, th);
+
+	return _sim_get_value_shared(slot, th, field, value, ctx);
+}
+
+static const char *_sim_value_get_string(const sim_value *value, sim_field_e field, int index)
+{
+	if (field != SIM_FIELD_IMSI)
+		return value->str[index];
+	if (index == 0)
+		return value->imsi.mcc;
+	if (index == 1)
+		return value->imsi.mnc;
+	return value->imsi.msin;
+}
+
+static int _sim_copy_to_buffer(const char *src, char *buf, size_t len)
+{
+	if (g_strlcpy(buf, src != NULL ? src : "", len) >= len) {
+		LOGE("[%s] TRUNCATED(0x%08x)", __FUNCTION__, SIM_ERROR_TRUNCATED);
+		return SIM_ERROR_TRUNCATED;
+	}
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_copy_value_to_buffers(const sim_value *value, sim_field_e field, int index, char *buf, size_t len,
+		char *buf2, size_t len2)
+{
+	int error_code = SIM_ERROR_NONE;
+	int error_code2 = SIM_ERROR_NONE;
+
+	error_code = _sim_copy_to_buffer(_sim_value_get_string(value, field, index), buf, len);
+	if (buf2 != NULL)
+		error_code2 = _sim_copy_to_buffer(value->str[1], buf2, len2);
+	return error_code != SIM_ERROR_NONE ? error_code : error_code2;
+}
+
+/* Copies one string of a value into caller storage, and the second one
+ * (the CPHS short name) into @buf2 if given. A value cached while the
+ * status is watched is copied straight out of the cache without touching
+ * the heap; anything else goes through _sim_get_value() and its copies. */
+static int _sim_get_value_r(sim_field_e field, int index, char *buf, size_t len, char *buf2, size_t len2)
+{
+	sim_slot *slot = &slots[SIM_SLOT_DEFAULT];
+	int error_code = SIM_ERROR_NONE;
+	gboolean hit = FALSE;
+	sim_value value;
+
+	if (g_atomic_int_get(&slot->status_watched)) {
+		g_rw_lock_reader_lock(&slot->cache_lock);
+		if (slot->cache.valid & SIM_FIELD_BIT(field)) {
+			error_code = _sim_copy_value_to_buffers(&slot->cache.values[field], field, index, buf, len, buf2,
+					len2);
+			hit = TRUE;
 		}
+		g_rw_lock_reader_unlock(&slot->cache_lock);
+		if (hit)
+			return error_code;
+	}
+
+	error_code = _sim_get_value(slot, field, &value, NULL);
+	if (error_code == SIM_ERROR_NONE) {
+		error_code = _sim_copy_value_to_buffers(&value, field, index, buf, len, buf2, len2);
+	} else {
+		buf[0] = '\0';
+		if (buf2 != NULL)
+			buf2[0] = '\0';
 	}
-	ret = tel_deregister_noti_event(ghandle, TAPI_NOTI_SIM_STATUS);
-	if (ret != TAPI_API_SUCCESS) error_code = SIM_ERROR_OPERATION_FAILED;
+	_sim_value_clear(&value);
 	return error_code;
 }
+
+/* Prefetch requests have no callback, their reply only fills the cache. */
+static void _sim_async_complete(sim_async_data *ad)
+{
+	switch (ad->cb != NULL ? ad->field : SIM_FIELD_MAX) {
+		case SIM_FIELD_MAX:
+			break;
+		case SIM_FIELD_IMSI:
+			((sim_get_imsi_info_cb) ad->cb)(ad->error_code,
+					ad->error_code == SIM_ERROR_NONE ? &ad->value.imsi : NULL, ad->user_data);
+			break;
+		case SIM_FIELD_CPHS:
+			((sim_get_cphs_operator_name_cb) ad->cb)(ad->error_code, ad->value.str[0], ad->value.str[1],
+					ad->user_data);
+			break;
+		default:
+			((sim_get_string_cb) ad->cb)(ad->error_code, ad->value.str[0], ad->user_data);
+			break;
+	}
+
+	_sim_value_clear(&ad->value);
+	if (ad->th != NULL)
+		_sim_handle_release(ad->slot, ad->th);
+	free(ad);
+}
+
+static gboolean _sim_async_complete_idle(gpointer user_data)
+{
+	_sim_async_complete(user_data);
+	return FALSE;
+}
+
+/* The optimistic request of @ad failed: it is NOT_AVAILABLE unless SIM card
+ * turns out to be initialized. */
+static void on_optimistic_status_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_async_data *ad = user_data;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	TelSimCardStatus_t sim_card_state = 0x00;
+	gboolean card_changed = FALSE;
+	int init_error = SIM_ERROR_NONE;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (!reply) {
+		init_error = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+		if (init_error == SIM_ERROR_OPERATION_FAILED) {
+			_sim_cache_invalidate(ad->slot);
+			init_error = SIM_ERROR_NOT_AVAILABLE;
+		}
+	} else {
+		g_variant_get(reply, "(ib)", &sim_card_state, &card_changed);
+		g_variant_unref(reply);
+		init_error = _sim_cache_check_card(ad->slot, sim_card_state, card_changed, &ad->generation);
+	}
+
+	LOGE("[%s] failed(0x%08x), init state (0x%08x)", __FUNCTION__, ad->error_code, init_error);
+	if (init_error != SIM_ERROR_NONE)
+		ad->error_code = init_error;
+	_sim_async_complete(ad);
+}
+
+static void on_value_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_async_data *ad = user_data;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (reply) {
+		ad->error_code = _sim_parse_value(ad->field, reply, &ad->value);
+		if (ad->error_code == SIM_ERROR_NONE
+				&& (!ad->optimistic || g_atomic_int_get(&ad->slot->status_watched)))
+			_sim_cache_set_value(ad->slot, ad->generation, ad->field, &ad->value);
+		g_variant_unref(reply);
+	} else {
+		ad->error_code = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+	}
+
+	if (ad->optimistic && ad->error_code != SIM_ERROR_NONE && ad->error_code != SIM_ERROR_TIMED_OUT
+			&& ad->error_code != SIM_ERROR_CANCELED) {
+		_sim_value_clear(&ad->value);
+		g_dbus_connection_call(ad->th->dbus_connection, DBUS_TELEPHONY_SERVICE, ad->th->path,
+				DBUS_TELEPHONY_SIM_INTERFACE, "GetInitStatus", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+				g_atomic_int_get(&call_timeout), NULL, on_optimistic_status_reply, ad);
+		return;
+	}
+	_sim_async_complete(ad);
+}
+
+static void on_init_status_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_async_data *ad = user_data;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	TelSimCardStatus_t sim_card_state = 0x00;
+	gboolean card_changed = FALSE;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (!reply) {
+		ad->error_code = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+		if (ad->error_code == SIM_ERROR_OPERATION_FAILED) {
+			_sim_cache_invalidate(ad->slot);
+			ad->error_code = SIM_ERROR_NOT_AVAILABLE;
+		}
+		_sim_async_complete(ad);
+		return;
+	}
+	/* Same reply tel_get_sim_init_info() parses. */
+	g_variant_get(reply, "(ib)", &sim_card_state, &card_changed);
+	g_variant_unref(reply);
+
+	if (_sim_cache_check_card(ad->slot, sim_card_state, card_changed, &ad->generation) != SIM_ERROR_NONE) {
+		LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
+		ad->error_code = SIM_ERROR_NOT_AVAILABLE;
+		_sim_async_complete(ad);
+	} else if (_sim_cache_get_value(ad->slot, ad->field, &ad->value, TRUE)) {
+		_sim_async_complete(ad);
+	} else {
+		g_dbus_connection_call(ad->th->dbus_connection, DBUS_TELEPHONY_SERVICE, ad->th->path,
+				DBUS_TELEPHONY_SIM_INTERFACE, sim_field_method[ad->field], NULL, NULL,
+				G_DBUS_CALL_FLAGS_NONE, g_atomic_int_get(&call_timeout), NULL, on_value_reply, ad);
+	}
+}
+
+/* Replies are dispatched on the thread-default main context of the caller,
+ * and so is a value served from the cache. */
+static int _sim_get_value_async(sim_field_e field, void *callback, void *user_data)
+{
+	sim_async_data *ad = NULL;
+	GMainContext *context = NULL;
+	GSource *source = NULL;
+
+	ad = (sim_async_data*) calloc(sizeof(sim_async_data), 1);
+	if (ad == NULL) {
+		LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+		return SIM_ERROR_OUT_OF_MEMORY;
+	}
+	ad->slot = &slots[SIM_SLOT_DEFAULT];
+	ad->field = field;
+	ad->cb = callback;
+	ad->user_data = user_data;
+
+	if (_sim_cache_get_value(ad->slot, field, &ad->value, FALSE)) {
+		context = g_main_context_ref_thread_default();
+		source = g_idle_source_new();
+		g_source_set_callback(source, _sim_async_complete_idle, ad, NULL);
+		g_source_attach(source, context);
+		g_source_unref(source);
+		g_main_context_unref(context);
+		return SIM_ERROR_NONE;
+	}
+
+	ad->th = _sim_handle_acquire(ad->slot);
+	if (ad->th == NULL) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		free(ad);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+
+	if (g_atomic_int_get(&optimistic_mode)) {
+		ad->optimistic = TRUE;
+		ad->generation = _sim_cache_generation(ad->slot);
+		g_dbus_connection_call(ad->th->dbus_connection, DBUS_TELEPHONY_SERVICE, ad->th->path,
+				DBUS_TELEPHONY_SIM_INTERFACE, sim_field_method[field], NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+				g_atomic_int_get(&call_timeout), NULL, on_value_reply, ad);
+		return SIM_ERROR_NONE;
+	}
+
+	g_dbus_connection_call(ad->th->dbus_connection, DBUS_TELEPHONY_SERVICE, ad->th->path,
+			DBUS_TELEPHONY_SIM_INTERFACE, "GetInitStatus", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+			g_atomic_int_get(&call_timeout), NULL, on_init_status_reply, ad);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_set_timeout(int timeout_ms)
+{
+	SIM_CHECK_TIMEOUT(timeout_ms);
+
+	g_atomic_int_set(&call_timeout, timeout_ms);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_set_optimistic_mode(bool enable)
+{
+	g_atomic_int_set(&optimistic_mode, enable ? TRUE : FALSE);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_get_timeout(int *timeout_ms)
+{
+	SIM_CHECK_INPUT_PARAMETER(timeout_ms);
+
+	*timeout_ms = g_atomic_int_get(&call_timeout);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_get_slot_count(int *count)
+{
+	SIM_CHECK_INPUT_PARAMETER(count);
+
+	*count = _sim_slot_count();
+	if (*count == 0) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_cancellable_create(sim_cancellable_h *cancellable)
+{
+	SIM_CHECK_INPUT_PARAMETER(cancellable);
+
+	*cancellable = (sim_cancellable_h) calloc(sizeof(struct sim_cancellable_s), 1);
+	if (*cancellable == NULL) {
+		LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+		return SIM_ERROR_OUT_OF_MEMORY;
+	}
+	(*cancellable)->cancellable = g_cancellable_new();
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_cancellable_cancel(sim_cancellable_h cancellable)
+{
+	SIM_CHECK_INPUT_PARAMETER(cancellable);
+
+	g_cancellable_cancel(cancellable->cancellable);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_cancellable_reset(sim_cancellable_h cancellable)
+{
+	SIM_CHECK_INPUT_PARAMETER(cancellable);
+
+	g_cancellable_reset(cancellable->cancellable);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_cancellable_destroy(sim_cancellable_h cancellable)
+{
+	SIM_CHECK_INPUT_PARAMETER(cancellable);
+
+	g_object_unref(cancellable->cancellable);
+	free(cancellable);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_get_icc_id_timed(int slot, char** icc_id, int timeout_ms, sim_cancellable_h cancellable)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_value value;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(icc_id);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+
+	*icc_id = NULL;
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	error_code = _sim_get_value(&slots[slot], SIM_FIELD_ICC_ID, &value, &ctx);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(value.str[0], icc_id);
+	_sim_value_clear(&value);
+	return error_code;
+}
+
+static int _sim_get_icc_id(char** icc_id)
+{
+	return _sim_get_icc_id_timed(SIM_SLOT_DEFAULT, icc_id, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_icc_id(int slot, char** icc_id)
+{
+	return _sim_get_icc_id_timed(slot, icc_id, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_icc_id_r(char *icc_id, size_t len)
+{
+	SIM_CHECK_INPUT_BUFFER(icc_id, len);
+	return _sim_get_value_r(SIM_FIELD_ICC_ID, 0, icc_id, len, NULL, 0);
+}
+
+static int _sim_get_icc_id_async(sim_get_string_cb callback, void *user_data)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	return _sim_get_value_async(SIM_FIELD_ICC_ID, callback, user_data);
+}
+
+static int _sim_get_imsi_info_timed(int slot, sim_imsi_info_s *imsi_info, int timeout_ms, sim_cancellable_h cancellable)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_value value;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(imsi_info);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	error_code = _sim_get_value(&slots[slot], SIM_FIELD_IMSI, &value, &ctx);
+	memcpy(imsi_info, &value.imsi, sizeof(sim_imsi_info_s));
+	_sim_value_clear(&value);
+	return error_code;
+}
+
+static int _sim_get_imsi_info(sim_imsi_info_s *imsi_info)
+{
+	return _sim_get_imsi_info_timed(SIM_SLOT_DEFAULT, imsi_info, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_imsi_info(int slot, sim_imsi_info_s *imsi_info)
+{
+	return _sim_get_imsi_info_timed(slot, imsi_info, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_imsi_info_async(sim_get_imsi_info_cb callback, void *user_data)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	return _sim_get_value_async(SIM_FIELD_IMSI, callback, user_data);
+}
+
+static int _sim_get_mcc(char** mcc)
+{
+	sim_imsi_info_s imsi_info;
+	int error_code = SIM_ERROR_NONE;
+
+	SIM_CHECK_INPUT_PARAMETER(mcc);
+
+	*mcc = NULL;
+	error_code = _sim_get_imsi_info(&imsi_info);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_string(imsi_info.mcc, mcc);
+	return error_code;
+}
+
+static int _sim_get_mcc_r(char *mcc, size_t len)
+{
+	SIM_CHECK_INPUT_BUFFER(mcc, len);
+	return _sim_get_value_r(SIM_FIELD_IMSI, 0, mcc, len, NULL, 0);
+}
+
+static int _sim_get_mnc(char** mnc)
+{
+	sim_imsi_info_s imsi_info;
+	int error_code = SIM_ERROR_NONE;
+
+	SIM_CHECK_INPUT_PARAMETER(mnc);
+
+	*mnc = NULL;
+	error_code = _sim_get_imsi_info(&imsi_info);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_string(imsi_info.mnc, mnc);
+	return error_code;
+}
+
+static int _sim_get_mnc_r(char *mnc, size_t len)
+{
+	SIM_CHECK_INPUT_BUFFER(mnc, len);
+	return _sim_get_value_r(SIM_FIELD_IMSI, 1, mnc, len, NULL, 0);
+}
+
+static int _sim_get_msin(char** msin)
+{
+	sim_imsi_info_s imsi_info;
+	int error_code = SIM_ERROR_NONE;
+
+	SIM_CHECK_INPUT_PARAMETER(msin);
+
+	*msin = NULL;
+	error_code = _sim_get_imsi_info(&imsi_info);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_string(imsi_info.msin, msin);
+	return error_code;
+}
+
+static int _sim_get_msin_r(char *msin, size_t len)
+{
+	SIM_CHECK_INPUT_BUFFER(msin, len);
+	return _sim_get_value_r(SIM_FIELD_IMSI, 2, msin, len, NULL, 0);
+}
+
+static int _sim_get_spn_timed(int slot, char** spn, int timeout_ms, sim_cancellable_h cancellable)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_value value;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(spn);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+
+	*spn = NULL;
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	error_code = _sim_get_value(&slots[slot], SIM_FIELD_SPN, &value, &ctx);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(value.str[0], spn);
+	_sim_value_clear(&value);
+	return error_code;
+}
+
+static int _sim_get_spn(char** spn)
+{
+	return _sim_get_spn_timed(SIM_SLOT_DEFAULT, spn, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_spn(int slot, char** spn)
+{
+	return _sim_get_spn_timed(slot, spn, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_spn_r(char *spn, size_t len)
+{
+	SIM_CHECK_INPUT_BUFFER(spn, len);
+	return _sim_get_value_r(SIM_FIELD_SPN, 0, spn, len, NULL, 0);
+}
+
+static int _sim_get_spn_async(sim_get_string_cb callback, void *user_data)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	return _sim_get_value_async(SIM_FIELD_SPN, callback, user_data);
+}
+
+static int _sim_get_cphs_operator_name_timed(int slot, char** full_name, char** short_name, int timeout_ms, sim_cancellable_h cancellable)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_value value;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(full_name);
+	SIM_CHECK_INPUT_PARAMETER(short_name);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+
+	*full_name = NULL;
+	*short_name = NULL;
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	error_code = _sim_get_value(&slots[slot], SIM_FIELD_CPHS, &value, &ctx);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(value.str[0], full_name);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(value.str[1], short_name);
+	if (error_code != SIM_ERROR_NONE) {
+		free(*full_name);
+		*full_name = NULL;
+	}
+	_sim_value_clear(&value);
+	return error_code;
+}
+
+static int _sim_get_cphs_operator_name(char** full_name, char** short_name)
+{
+	return _sim_get_cphs_operator_name_timed(SIM_SLOT_DEFAULT, full_name, short_name, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_cphs_operator_name(int slot, char** full_name, char** short_name)
+{
+	return _sim_get_cphs_operator_name_timed(slot, full_name, short_name, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_cphs_operator_name_r(char *full_name, size_t full_len, char *short_name, size_t short_len)
+{
+	SIM_CHECK_INPUT_BUFFER(full_name, full_len);
+	SIM_CHECK_INPUT_BUFFER(short_name, short_len);
+	return _sim_get_value_r(SIM_FIELD_CPHS, 0, full_name, full_len, short_name, short_len);
+}
+
+static int _sim_get_cphs_operator_name_async(sim_get_cphs_operator_name_cb callback, void *user_data)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	return _sim_get_value_async(SIM_FIELD_CPHS, callback, user_data);
+}
+
+static int _sim_get_state_timed(int slot, sim_state_e* sim_state, int timeout_ms, sim_cancellable_h cancellable)
+{
+	gboolean card_changed = FALSE;
+	TelSimCardStatus_t sim_card_state = 0x00;
+	int error_code = SIM_ERROR_NONE;
+	struct tapi_handle *th = NULL;
+	gint mirrored = 0;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(sim_state);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+
+	mirrored = g_atomic_int_get(&slots[slot].state_mirror);
+	if (mirrored >= 0) {
+		*sim_state = mirrored;
+		return SIM_ERROR_NONE;
+	}
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	SIM_INIT(&slots[slot], th);
+
+	error_code = _sim_get_init_status(th, &ctx, &sim_card_state, &card_changed);
+	if (error_code != SIM_ERROR_NONE) {
+		LOGE("[%s] failed(0x%08x)", __FUNCTION__, error_code);
+	} else {
+		*sim_state = _convert_card_status_to_sim_state(sim_card_state);
+		_sim_state_mirror_update(&slots[slot], *sim_state, FALSE);
+	}
+
+	return error_code;
+}
+
+static int _sim_get_state(sim_state_e* sim_state)
+{
+	return _sim_get_state_timed(SIM_SLOT_DEFAULT, sim_state, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_state(int slot, sim_state_e* sim_state)
+{
+	return _sim_get_state_timed(slot, sim_state, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_subscriber_number_timed(int slot, char** subscriber_number, int timeout_ms, sim_cancellable_h cancellable)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_value value;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(subscriber_number);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+
+	*subscriber_number = NULL;
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	error_code = _sim_get_value(&slots[slot], SIM_FIELD_MSISDN, &value, &ctx);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(value.str[0], subscriber_number);
+	_sim_value_clear(&value);
+	return error_code;
+}
+
+static int _sim_get_subscriber_number(char** subscriber_number)
+{
+	return _sim_get_subscriber_number_timed(SIM_SLOT_DEFAULT, subscriber_number, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_subscriber_number(int slot, char** subscriber_number)
+{
+	return _sim_get_subscriber_number_timed(slot, subscriber_number, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_subscriber_number_r(char *subscriber_number, size_t len)
+{
+	SIM_CHECK_INPUT_BUFFER(subscriber_number, len);
+	return _sim_get_value_r(SIM_FIELD_MSISDN, 0, subscriber_number, len, NULL, 0);
+}
+
+static int _sim_get_subscriber_number_async(sim_get_string_cb callback, void *user_data)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	return _sim_get_value_async(SIM_FIELD_MSISDN, callback, user_data);
+}
+
+static int _sim_get_msisdn_list(sim_msisdn_list_h *list)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_value value;
+
+	SIM_CHECK_INPUT_PARAMETER(list);
+
+	*list = NULL;
+	error_code = _sim_get_value(&slots[SIM_SLOT_DEFAULT], SIM_FIELD_MSISDN, &value, NULL);
+	if (error_code == SIM_ERROR_NONE) {
+		*list = (sim_msisdn_list_h) calloc(sizeof(struct sim_msisdn_list_s), 1);
+		if (*list == NULL) {
+			LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+			error_code = SIM_ERROR_OUT_OF_MEMORY;
+		} else {
+			/* FILE_NOT_FOUND is reported as success without any entry. */
+			(*list)->rows = value.list;
+			value.list = NULL;
+		}
+	}
+	_sim_value_clear(&value);
+	return error_code;
+}
+
+static int _sim_msisdn_list_get_count(sim_msisdn_list_h list, int *count)
+{
+	SIM_CHECK_INPUT_PARAMETER(list);
+	SIM_CHECK_INPUT_PARAMETER(count);
+
+	*count = list->rows != NULL ? g_variant_n_children(list->rows) : 0;
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_msisdn_list_get_at(sim_msisdn_list_h list, int index, const char **number, const char **name)
+{
+	GVariant *row = NULL;
+	const gchar *str_value = NULL;
+
+	SIM_CHECK_INPUT_PARAMETER(list);
+	SIM_CHECK_INPUT_PARAMETER(number);
+	SIM_CHECK_INPUT_PARAMETER(name);
+	if (list->rows == NULL || index < 0 || index >= g_variant_n_children(list->rows)) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+
+	/* The strings point into the reply held by @list, so dropping the row
+	 * view right away is fine. */
+	row = g_variant_get_child_value(list->rows, index);
+	*number = g_variant_lookup(row, "number", "&s", &str_value) ? str_value : NULL;
+	*name = g_variant_lookup(row, "name", "&s", &str_value) ? str_value : NULL;
+	g_variant_unref(row);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_msisdn_list_destroy(sim_msisdn_list_h list)
+{
+	SIM_CHECK_INPUT_PARAMETER(list);
+
+	if (list->rows != NULL)
+		g_variant_unref(list->rows);
+	free(list);
+	return SIM_ERROR_NONE;
+}
+
+static void _sim_release_snapshot(sim_snapshot_s *snapshot)
+{
+	if (snapshot == NULL)
+		return;
+
+	free(snapshot->icc_id);
+	free(snapshot->spn);
+	free(snapshot->cphs_full_name);
+	free(snapshot->cphs_short_name);
+	free(snapshot->subscriber_number);
+	memset(snapshot, 0, sizeof(sim_snapshot_s));
+	snapshot->state = SIM_STATE_UNKNOWN;
+}
+
+static void on_snapshot_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_snapshot_request *req = user_data;
+	sim_snapshot_data *sd = req->sd;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	int error_code = SIM_ERROR_NONE;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (reply) {
+		error_code = _sim_parse_value(req->field, reply, &sd->values[req->field]);
+		if (error_code == SIM_ERROR_NONE)
+			_sim_cache_set_value(sd->slot, sd->generation, req->field, &sd->values[req->field]);
+		g_variant_unref(reply);
+	} else {
+		error_code = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+	}
+
+	if (sd->error_code == SIM_ERROR_NONE)
+		sd->error_code = error_code;
+	(*sd->pending)--;
+}
+
+/* Sends the requests of all fields missing from the cache at once. */
+static void _sim_snapshot_send_values(sim_snapshot_data *sd)
+{
+	int timeout = _sim_call_ctx_timeout(sd->ctx);
+	int i = 0;
+
+	if (timeout == 0) {
+		sd->error_code = SIM_ERROR_TIMED_OUT;
+		return;
+	}
+
+	for (i = 0; i < SIM_FIELD_MAX; i++) {
+		if (_sim_cache_get_value(sd->slot, i, &sd->values[i], TRUE))
+			continue;
+		sd->requests[i].sd = sd;
+		sd->requests[i].field = i;
+		(*sd->pending)++;
+		g_dbus_connection_call(sd->th->dbus_connection, DBUS_TELEPHONY_SERVICE, sd->th->path,
+				DBUS_TELEPHONY_SIM_INTERFACE, sim_field_method[i], NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+				timeout, sd->ctx->cancellable, on_snapshot_reply, &sd->requests[i]);
+	}
+}
+
+static void on_snapshot_status_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_snapshot_data *sd = user_data;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	TelSimCardStatus_t sim_card_state = 0x00;
+	gboolean card_changed = FALSE;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (reply) {
+		g_variant_get(reply, "(ib)", &sim_card_state, &card_changed);
+		g_variant_unref(reply);
+		sd->state = _convert_card_status_to_sim_state(sim_card_state);
+		/* Only the state is reported for a card which is not initialized. */
+		if (_sim_cache_check_card(sd->slot, sim_card_state, card_changed, &sd->generation) == SIM_ERROR_NONE)
+			_sim_snapshot_send_values(sd);
+	} else {
+		sd->error_code = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+		/* The same as _sim_check_init() */
+		if (sd->error_code == SIM_ERROR_OPERATION_FAILED) {
+			_sim_cache_invalidate(sd->slot);
+			sd->error_code = SIM_ERROR_NOT_AVAILABLE;
+		}
+	}
+	(*sd->pending)--;
+}
+
+static void _sim_snapshot_data_init(sim_snapshot_data *sd, sim_slot *slot)
+{
+	memset(sd, 0, sizeof(sim_snapshot_data));
+	sd->slot = slot;
+	sd->state = SIM_STATE_UNKNOWN;
+	sd->th = _sim_handle_borrow(slot);
+	if (sd->th == NULL) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		sd->error_code = SIM_ERROR_OPERATION_FAILED;
+	}
+}
+
+static void _sim_snapshot_data_clear(sim_snapshot_data *sd)
+{
+	int i = 0;
+
+	for (i = 0; i < SIM_FIELD_MAX; i++)
+		_sim_value_clear(&sd->values[i]);
+}
+
+/* Reads the init status of all @count slots at once, then the fields of
+ * each initialized card as soon as its status is in, and iterates a
+ * private main context until every reply is in. A slot takes as long as
+ * its two round trips, whatever the number of slots. */
+static void _sim_get_snapshots(sim_snapshot_data *sds, int count, const sim_call_ctx *ctx)
+{
+	GMainContext *context = NULL;
+	int timeout = _sim_call_ctx_timeout(ctx);
+	int pending = 0;
+	int i = 0;
+
+	context = g_main_context_new();
+	g_main_context_push_thread_default(context);
+
+	for (i = 0; i < count; i++) {
+		if (sds[i].th == NULL)
+			continue;
+		sds[i].ctx = ctx;
+		sds[i].pending = &pending;
+		if (timeout == 0) {
+			sds[i].error_code = SIM_ERROR_TIMED_OUT;
+			continue;
+		}
+		pending++;
+		g_dbus_connection_call(sds[i].th->dbus_connection, DBUS_TELEPHONY_SERVICE, sds[i].th->path,
+				DBUS_TELEPHONY_SIM_INTERFACE, "GetInitStatus", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+				timeout, ctx->cancellable, on_snapshot_status_reply, &sds[i]);
+	}
+
+	while (pending > 0)
+		g_main_context_iteration(context, TRUE);
+
+	g_main_context_pop_thread_default(context);
+	g_main_context_unref(context);
+}
+
+/* On failure only the state is kept, if it could be read. */
+static int _sim_fill_snapshot(const sim_snapshot_data *sd, sim_snapshot_s *snapshot)
+{
+	int error_code = sd->error_code;
+
+	if (error_code == SIM_ERROR_NONE) {
+		memcpy(&snapshot->imsi_info, &sd->values[SIM_FIELD_IMSI].imsi, sizeof(sim_imsi_info_s));
+		error_code = _sim_copy_optional_string(sd->values[SIM_FIELD_ICC_ID].str[0], &snapshot->icc_id);
+	}
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(sd->values[SIM_FIELD_SPN].str[0], &snapshot->spn);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(sd->values[SIM_FIELD_CPHS].str[0], &snapshot->cphs_full_name);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(sd->values[SIM_FIELD_CPHS].str[1], &snapshot->cphs_short_name);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(sd->values[SIM_FIELD_MSISDN].str[0], &snapshot->subscriber_number);
+	if (error_code != SIM_ERROR_NONE) {
+		LOGE("[%s] slot %d failed(0x%08x)", __FUNCTION__, sd->slot->index, error_code);
+		_sim_release_snapshot(snapshot);
+	}
+	snapshot->state = sd->state;
+	return error_code;
+}
+
+static int _sim_get_snapshot_timed(int slot, sim_snapshot_s *snapshot, int timeout_ms, sim_cancellable_h cancellable)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_snapshot_data sd;
+	sim_call_ctx ctx;
+
+	SIM_CHECK_INPUT_PARAMETER(snapshot);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+	memset(snapshot, 0, sizeof(sim_snapshot_s));
+	snapshot->state = SIM_STATE_UNKNOWN;
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+
+	_sim_snapshot_data_init(&sd, &slots[slot]);
+	if (sd.th == NULL)
+		return sd.error_code;
+	_sim_get_snapshots(&sd, 1, &ctx);
+	error_code = _sim_fill_snapshot(&sd, snapshot);
+	_sim_snapshot_data_clear(&sd);
+	return error_code;
+}
+
+static int _sim_get_snapshot(sim_snapshot_s *snapshot)
+{
+	return _sim_get_snapshot_timed(SIM_SLOT_DEFAULT, snapshot, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_get_snapshot(int slot, sim_snapshot_s *snapshot)
+{
+	return _sim_get_snapshot_timed(slot, snapshot, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_get_all_snapshots(sim_snapshot_s *snapshots, int max_count, int *count)
+{
+	int error_code = SIM_ERROR_NONE;
+	int slot_error = SIM_ERROR_NONE;
+	sim_snapshot_data sds[SIM_SLOT_MAX];
+	sim_call_ctx ctx;
+	int i = 0;
+
+	SIM_CHECK_INPUT_PARAMETER(snapshots);
+	SIM_CHECK_INPUT_PARAMETER(count);
+	if (max_count <= 0) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+
+	*count = MIN(_sim_slot_count(), max_count);
+	if (*count == 0) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+	_sim_call_ctx_init(&ctx, SIM_TIMEOUT_DEFAULT, NULL);
+
+	for (i = 0; i < *count; i++) {
+		memset(&snapshots[i], 0, sizeof(sim_snapshot_s));
+		snapshots[i].state = SIM_STATE_UNKNOWN;
+		_sim_snapshot_data_init(&sds[i], &slots[i]);
+	}
+	_sim_get_snapshots(sds, *count, &ctx);
+
+	/* The first failure is returned, the other slots are filled anyway. */
+	for (i = 0; i < *count; i++) {
+		slot_error = _sim_fill_snapshot(&sds[i], &snapshots[i]);
+		if (error_code == SIM_ERROR_NONE)
+			error_code = slot_error;
+		_sim_snapshot_data_clear(&sds[i]);
+	}
+	return error_code;
+}
+
+/* Maps the status words of the card (ISO/IEC 7816-4, 3GPP TS 51.011) to
+ * the access results the other requests report. */
+static TelSimAccessResult_t _sim_convert_status_words(unsigned char sw1, unsigned char sw2)
+{
+	switch (sw1) {
+		case 0x90:	/* Normal ending */
+		case 0x91:	/* Normal ending, with a proactive command pending */
+		case 0x92:	/* Normal ending after internal retries */
+		case 0x9F:	/* Normal ending, response data available */
+		case 0x62:	/* Warning, e.g. end of file reached before Le bytes */
+			return TAPI_SIM_ACCESS_SUCCESS;
+		case 0x6A:
+			/* File or record not found */
+			return sw2 == 0x82 || sw2 == 0x83 ? TAPI_SIM_ACCESS_FILE_NOT_FOUND : TAPI_SIM_ACCESS_FAILED;
+		case 0x94:
+			/* Out of range (invalid record) or file ID not found */
+			return sw2 == 0x02 || sw2 == 0x04 ? TAPI_SIM_ACCESS_FILE_NOT_FOUND : TAPI_SIM_ACCESS_FAILED;
+		case 0x69:	/* Security status not satisfied, command not allowed */
+		case 0x98:	/* Access condition not fulfilled, CHV blocked */
+			return TAPI_SIM_ACCESS_ACCESS_CONDITION_NOT_SATISFIED;
+		case 0x64:
+		case 0x65:	/* Memory problem */
+		case 0x6F:	/* Technical problem */
+			return TAPI_SIM_ACCESS_CARD_ERROR;
+		default:
+			return TAPI_SIM_ACCESS_FAILED;
+	}
+}
+
+static void on_file_reply(GObject *source_object, GAsyncResult *res, gpointer user_data);
+static void _sim_prefetch(sim_slot *slot);
+
+/* AccessRSim of the telephony daemon, as sent by tel_req_sim_access():
+ * in (cmd, file_id, p1, p2, p3, v(ay) data), out (result, sw1, sw2,
+ * v(ay) response). p3 of 0 is Le = 00, the whole record or up to 256 bytes
+ * of a transparent file; a card which wants the exact length says so with
+ * 0x67 or 0x6C and it is sent again once, see on_file_reply(). */
+static void _sim_file_request_send(sim_file_request *req)
+{
+	const sim_file_s *file = req->file;
+	int timeout = _sim_call_ctx_timeout(req->batch->ctx);
+	GVariant *param = NULL;
+
+	if (timeout == 0) {
+		req->error_code = SIM_ERROR_TIMED_OUT;
+		return;
+	}
+	param = g_variant_new("(iiiiiv)", file->record != 0 ? SIM_RSIM_READ_RECORD : SIM_RSIM_READ_BINARY,
+			file->file_id, file->record, file->record != 0 ? SIM_RSIM_RECORD_ABSOLUTE : 0, req->p3,
+			g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, NULL, 0, 1));
+	req->batch->pending++;
+	g_dbus_connection_call(req->batch->th->dbus_connection, DBUS_TELEPHONY_SERVICE, req->batch->th->path,
+			DBUS_TELEPHONY_SIM_INTERFACE, "AccessRSim", param, NULL, G_DBUS_CALL_FLAGS_NONE,
+			timeout, req->batch->ctx->cancellable, on_file_reply, req);
+}
+
+static void on_file_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_file_request *req = user_data;
+	TelSimAccessResult_t result = TAPI_SIM_ACCESS_SUCCESS;
+	TelSimAccessResult_t sw_result = TAPI_SIM_ACCESS_SUCCESS;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	GVariant *content = NULL;
+	int sw1 = 0;
+	int sw2 = 0;
+
+	req->batch->pending--;
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (reply == NULL) {
+		req->error_code = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+		return;
+	}
+
+	g_variant_get(reply, "(iii@v)", &result, &sw1, &sw2, &content);
+	g_variant_unref(reply);
+	req->content = g_variant_get_variant(content);
+	g_variant_unref(content);
+	req->sw1 = sw1;
+	req->sw2 = sw2;
+
+	/* Wrong length, sw2 being the right one */
+	if ((sw1 == 0x67 || sw1 == 0x6C) && sw2 != 0 && !req->resent) {
+		g_variant_unref(req->content);
+		req->content = NULL;
+		req->resent = TRUE;
+		req->p3 = sw2;
+		_sim_file_request_send(req);
+		return;
+	}
+
+	/* The daemon fails the request for some status words, which still
+	 * tell why. */
+	sw_result = _sim_convert_status_words(req->sw1, req->sw2);
+	if (result == TAPI_SIM_ACCESS_SUCCESS || (result == TAPI_SIM_ACCESS_FAILED && sw_result != TAPI_SIM_ACCESS_SUCCESS))
+		result = sw_result;
+	req->error_code = _convert_access_rt_to_sim_error(result);
+
+	/* FILE_NOT_FOUND is reported as success with an empty content. */
+	if (req->error_code != SIM_ERROR_NONE || result == TAPI_SIM_ACCESS_FILE_NOT_FOUND
+			|| !g_variant_is_of_type(req->content, G_VARIANT_TYPE_BYTESTRING)) {
+		if (req->error_code == SIM_ERROR_NONE && result != TAPI_SIM_ACCESS_FILE_NOT_FOUND)
+			req->error_code = SIM_ERROR_OPERATION_FAILED;
+		g_variant_unref(req->content);
+		req->content = NULL;
+	}
+	if (req->error_code != SIM_ERROR_NONE)
+		LOGE("[%s] file 0x%04x: sw 0x%02x 0x%02x, failed(0x%08x)", __FUNCTION__, req->file->file_id,
+				req->sw1, req->sw2, req->error_code);
+}
+
+static void on_file_status_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_file_batch *batch = user_data;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	TelSimCardStatus_t sim_card_state = 0x00;
+	gboolean card_changed = FALSE;
+	unsigned int generation = 0;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (reply) {
+		g_variant_get(reply, "(ib)", &sim_card_state, &card_changed);
+		g_variant_unref(reply);
+		batch->init_error = _sim_cache_check_card(batch->slot, sim_card_state, card_changed, &generation);
+	} else {
+		batch->init_error = _convert_gerror_to_sim_error(gerr);
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+		if (batch->init_error == SIM_ERROR_OPERATION_FAILED) {
+			_sim_cache_invalidate(batch->slot);
+			batch->init_error = SIM_ERROR_NOT_AVAILABLE;
+		}
+	}
+	batch->pending--;
+}
+
+/* Packs the contents in the order of the files; one which does not fit in
+ * what is left of @buffer still reports its length. */
+static void _sim_file_batch_fill(const sim_file_batch *batch, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results)
+{
+	gconstpointer data = NULL;
+	gsize size = 0;
+	size_t offset = 0;
+	int i = 0;
+
+	for (i = 0; i < count; i++) {
+		memset(&results[i], 0, sizeof(sim_file_result_s));
+		results[i].error = batch->init_error != SIM_ERROR_NONE ? batch->init_error : batch->requests[i].error_code;
+		results[i].sw1 = batch->requests[i].sw1;
+		results[i].sw2 = batch->requests[i].sw2;
+		if (results[i].error != SIM_ERROR_NONE || batch->requests[i].content == NULL)
+			continue;
+
+		data = g_variant_get_fixed_array(batch->requests[i].content, &size, 1);
+		results[i].length = size;
+		if (size > len - offset) {
+			results[i].error = SIM_ERROR_TRUNCATED;
+			continue;
+		}
+		memcpy(buffer + offset, data, size);
+		results[i].offset = offset;
+		offset += size;
+	}
+}
+
+/* The init status and every file are requested at once, so the whole batch
+ * takes one round trip. The daemon has no method reading several files, so
+ * each file is still one AccessRSim request. */
+static int _sim_read_files_timed(int slot, const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results, int timeout_ms, sim_cancellable_h cancellable)
+{
+	struct tapi_handle *th = NULL;
+	GMainContext *context = NULL;
+	sim_file_batch batch;
+	sim_call_ctx ctx;
+	int i = 0;
+
+	SIM_CHECK_INPUT_PARAMETER(files);
+	SIM_CHECK_INPUT_PARAMETER(results);
+	SIM_CHECK_TIMEOUT(timeout_ms);
+	SIM_CHECK_SLOT(slot);
+	if (count <= 0 || (buffer == NULL && len > 0)) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+	SIM_INIT(&slots[slot], th);
+	_sim_call_ctx_init(&ctx, timeout_ms, cancellable);
+	if (_sim_call_ctx_timeout(&ctx) == 0) {
+		LOGE("[%s] TIMED_OUT(0x%08x)", __FUNCTION__, SIM_ERROR_TIMED_OUT);
+		return SIM_ERROR_TIMED_OUT;
+	}
+
+	memset(&batch, 0, sizeof(sim_file_batch));
+	batch.slot = &slots[slot];
+	batch.th = th;
+	batch.ctx = &ctx;
+	batch.requests = g_new0(sim_file_request, count);
+	context = g_main_context_new();
+	g_main_context_push_thread_default(context);
+
+	batch.pending++;
+	g_dbus_connection_call(th->dbus_connection, DBUS_TELEPHONY_SERVICE, th->path,
+			DBUS_TELEPHONY_SIM_INTERFACE, "GetInitStatus", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+			_sim_call_ctx_timeout(&ctx), ctx.cancellable, on_file_status_reply, &batch);
+	for (i = 0; i < count; i++) {
+		batch.requests[i].batch = &batch;
+		batch.requests[i].file = &files[i];
+		_sim_file_request_send(&batch.requests[i]);
+	}
+
+	while (batch.pending > 0)
+		g_main_context_iteration(context, TRUE);
+
+	g_main_context_pop_thread_default(context);
+	g_main_context_unref(context);
+
+	_sim_file_batch_fill(&batch, count, buffer, len, results);
+	for (i = 0; i < count; i++) {
+		if (batch.requests[i].content != NULL)
+			g_variant_unref(batch.requests[i].content);
+	}
+	g_free(batch.requests);
+	if (batch.init_error != SIM_ERROR_NONE)
+		LOGE("[%s] failed(0x%08x)", __FUNCTION__, batch.init_error);
+	return batch.init_error;
+}
+
+static int _sim_read_files(const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results)
+{
+	return _sim_read_files_timed(SIM_SLOT_DEFAULT, files, count, buffer, len, results, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_slot_read_files(int slot, const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results)
+{
+	return _sim_read_files_timed(slot, files, count, buffer, len, results, SIM_TIMEOUT_DEFAULT, NULL);
+}
+
+static int _sim_lookup_operator(const char *mcc, const char *mnc, const char **country, const char **name)
+{
+	SIM_CHECK_INPUT_PARAMETER(mcc);
+	SIM_CHECK_INPUT_PARAMETER(country);
+
+	return _sim_operator_lookup(mcc, mnc, country, name);
+}
+
+/* A name which does not fit is skipped rather than cut. */
+static gboolean _sim_home_operator_set_name(sim_home_operator_info_s *info, const char *name,
+		sim_operator_name_source_e source)
+{
+	if (name == NULL || name[0] == '\0' || g_strlcpy(info->name, name, sizeof(info->name)) >= sizeof(info->name)) {
+		info->name[0] = '\0';
+		return FALSE;
+	}
+	info->name_source = source;
+	return TRUE;
+}
+
+static int _sim_get_home_operator_info(sim_home_operator_info_s *info)
+{
+	sim_slot *slot = &slots[SIM_SLOT_DEFAULT];
+	int error_code = SIM_ERROR_NONE;
+	const char *country = NULL;
+	const char *name = NULL;
+	gboolean named = FALSE;
+	sim_value value;
+
+	SIM_CHECK_INPUT_PARAMETER(info);
+	memset(info, 0, sizeof(sim_home_operator_info_s));
+
+	error_code = _sim_get_value(slot, SIM_FIELD_IMSI, &value, NULL);
+	if (error_code != SIM_ERROR_NONE) {
+		LOGE("[%s] failed(0x%08x)", __FUNCTION__, error_code);
+		_sim_value_clear(&value);
+		return error_code;
+	}
+	snprintf(info->mcc, sizeof(info->mcc), "%s", value.imsi.mcc);
+	snprintf(info->mnc, sizeof(info->mnc), "%s", value.imsi.mnc);
+	_sim_value_clear(&value);
+	if (_sim_operator_lookup(info->mcc, info->mnc, &country, &name) == SIM_ERROR_NONE)
+		snprintf(info->country, sizeof(info->country), "%s", country);
+
+	/* The SPN is what the operator wants displayed, the CPHS name is the
+	 * older home network name, the table only knows the brand. */
+	if (_sim_get_value(slot, SIM_FIELD_SPN, &value, NULL) == SIM_ERROR_NONE)
+		named = _sim_home_operator_set_name(info, value.str[0], SIM_OPERATOR_NAME_SPN);
+	_sim_value_clear(&value);
+	if (!named && _sim_get_value(slot, SIM_FIELD_CPHS, &value, NULL) == SIM_ERROR_NONE)
+		named = _sim_home_operator_set_name(info, value.str[0], SIM_OPERATOR_NAME_CPHS)
+				|| _sim_home_operator_set_name(info, value.str[1], SIM_OPERATOR_NAME_CPHS);
+	_sim_value_clear(&value);
+	if (!named)
+		_sim_home_operator_set_name(info, name, SIM_OPERATOR_NAME_TABLE);
+	return SIM_ERROR_NONE;
+}
+
+/* Copies the listeners of @slot which have not seen @state yet and marks it
+ * as seen, so each listener is only called when the state really changes. */
+static sim_cb_data *_sim_copy_state_listeners_locked(sim_slot *slot, sim_state_e state, int *count)
+{
+	GHashTableIter iter;
+	gpointer value = NULL;
+	sim_cb_data *ccb = NULL;
+	sim_cb_data *listeners = NULL;
+	int i = 0;
+
+	*count = 0;
+	if (slot->listener_count == 0)
+		return NULL;
+
+	listeners = (sim_cb_data*) calloc(sizeof(sim_cb_data), slot->listener_count);
+	if (listeners == NULL) {
+		LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+		return NULL;
+	}
+
+	g_hash_table_iter_init(&iter, state_listeners);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		ccb = value;
+		if (ccb->slot != slot || ccb->previous_state == state)
+			continue;
+		ccb->previous_state = state;
+		memcpy(&listeners[i++], ccb, sizeof(sim_cb_data));
+	}
+	*count = i;
+	return listeners;
+}
+
+/* @received is when the Status signal which brought @state was read from
+ * the bus, 0 if unknown. */
+static void _sim_deliver_state(sim_slot *slot, sim_state_e state, unsigned long long received)
+{
+	sim_cb_data *listeners = NULL;
+	int count = 0;
+	int i = 0;
+
+	/* Listeners may be added or removed from their callbacks, so call them
+	 * on a copy taken under the lock. */
+	G_LOCK(state_listeners);
+	slot->last_state = state;
+	listeners = _sim_copy_state_listeners_locked(slot, state, &count);
+	G_UNLOCK(state_listeners);
+
+	if (received != 0 && count > 0)
+		SIM_STATS_END(SIM_STAT_DISPATCH_STATUS, received, SIM_ERROR_NONE);
+
+	for (i = 0; i < count; i++) {
+		if (listeners[i].with_slot)
+			((sim_slot_state_changed_cb) listeners[i].cb)(slot->index, state, listeners[i].user_data);
+		else
+			((sim_state_changed_cb) listeners[i].cb)(state, listeners[i].user_data);
+	}
+	free(listeners);
+}
+
+static gboolean _sim_debounce_expired(gpointer user_data)
+{
+	sim_slot *slot = user_data;
+	sim_state_e state = SIM_STATE_NONE;
+	unsigned long long received = 0;
+
+	G_LOCK(state_listeners);
+	state = slot->pending_state;
+	received = slot->pending_received;
+	if (slot->debounce_source != NULL) {
+		g_source_unref(slot->debounce_source);
+		slot->debounce_source = NULL;
+	}
+	G_UNLOCK(state_listeners);
+
+	_sim_deliver_state(slot, state, received);
+	return FALSE;
+}
+
+/* A full ring keeps the newest state in its last entry, so that the last
+ * change read is always the state the card is in. The reader is held off
+ * meanwhile, as it may be reading that entry. */
+static void _sim_event_push(sim_slot *slot, sim_state_e state)
+{
+	sim_event_ring *ring = &slot->events;
+	sim_event_s *event = NULL;
+	guint64 one = 1;
+	guint tail = 0;
+	gboolean locked = FALSE;
+	int fd = g_atomic_int_get(&event_fd);
+
+	if (fd < 0 || state == ring->last_state)
+		return;
+
+	tail = (guint) g_atomic_int_get(&ring->tail);
+	if (tail - (guint) g_atomic_int_get(&ring->head) == SIM_EVENT_RING_SIZE) {
+		G_LOCK(event_reader);
+		locked = TRUE;
+	}
+	if (locked && tail - (guint) g_atomic_int_get(&ring->head) == SIM_EVENT_RING_SIZE) {
+		LOGE("[%s] slot %d: ring full, newest state replaced by %d", __FUNCTION__, slot->index, state);
+		tail--;
+		/* Back to the state before the replaced one: no change left. */
+		if (ring->events[(tail - 1) & (SIM_EVENT_RING_SIZE - 1)].state == state) {
+			ring->last_state = state;
+			g_atomic_int_set(&ring->tail, (gint) tail);
+			G_UNLOCK(event_reader);
+			return;
+		}
+	}
+	event = &ring->events[tail & (SIM_EVENT_RING_SIZE - 1)];
+	event->slot = slot->index;
+	event->state = state;
+	event->timestamp = g_get_monotonic_time();
+	ring->last_state = state;
+	g_atomic_int_set(&ring->tail, (gint) (tail + 1));
+	if (locked)
+		G_UNLOCK(event_reader);
+
+	if (write(fd, &one, sizeof(one)) < 0)
+		LOGE("[%s] write failed", __FUNCTION__);
+}
+
+/* Stamps the Status signals of the slot in @user_data as they are read
+ * from the bus, before libtapi queues them to the subscribing context.
+ * Runs in the GDBus worker thread, only in builds with SIM_ENABLE_STATS. */
+static GDBusMessage *_sim_status_filter(GDBusConnection *connection, GDBusMessage *message,
+		gboolean incoming, gpointer user_data)
+{
+	sim_slot *slot = user_data;
+	sim_stamp_ring *ring = &slot->status_stamps;
+	const char *path = NULL;
+	guint tail = 0;
+
+	if (!incoming || g_dbus_message_get_message_type(message) != G_DBUS_MESSAGE_TYPE_SIGNAL
+			|| g_strcmp0(g_dbus_message_get_member(message), "Status") != 0
+			|| g_strcmp0(g_dbus_message_get_interface(message), DBUS_TELEPHONY_SIM_INTERFACE) != 0)
+		return message;
+
+	path = g_dbus_message_get_path(message);
+	if (path == NULL || g_quark_try_string(path) != (GQuark) g_atomic_int_get(&slot->status_path))
+		return message;
+
+	tail = (guint) g_atomic_int_get(&ring->tail);
+	if (tail - (guint) g_atomic_int_get(&ring->head) < SIM_STAMP_RING_SIZE) {
+		ring->stamps[tail & (SIM_STAMP_RING_SIZE - 1)] = SIM_STATS_NOW();
+		g_atomic_int_set(&ring->tail, (gint) (tail + 1));
+	}
+	return message;
+}
+
+/* 0 if the signal being dispatched was not stamped. */
+static unsigned long long _sim_stamp_pop(sim_slot *slot)
+{
+	sim_stamp_ring *ring = &slot->status_stamps;
+	unsigned long long stamp = 0;
+	guint head = (guint) g_atomic_int_get(&ring->head);
+
+	if (head == (guint) g_atomic_int_get(&ring->tail))
+		return 0;
+	stamp = ring->stamps[head & (SIM_STAMP_RING_SIZE - 1)];
+	g_atomic_int_set(&ring->head, (gint) (head + 1));
+	return stamp;
+}
+
+static gpointer _sim_worker_run(gpointer data)
+{
+	GMainLoop *loop = data;
+
+	g_main_context_push_thread_default(g_main_loop_get_context(loop));
+	g_main_loop_run(loop);
+	g_main_context_pop_thread_default(g_main_loop_get_context(loop));
+	g_main_loop_unref(loop);
+	return NULL;
+}
+
+/* The context of the library's worker thread, started on first use. */
+static GMainContext *_sim_worker_context(void)
+{
+	G_LOCK(worker);
+	if (worker_context == NULL) {
+		worker_context = g_main_context_new();
+		g_thread_unref(g_thread_new("sim-worker", _sim_worker_run, g_main_loop_new(worker_context, FALSE)));
+	}
+	G_UNLOCK(worker);
+	return worker_context;
+}
+
+static void on_noti_sim_status(struct tapi_handle *handle, const char *noti_id, void *data,
+		void *user_data)
+{
+	sim_slot *slot = user_data;
+	TelSimCardStatus_t *status = data;
+	sim_state_e state = SIM_STATE_UNKNOWN;
+	GSource *current = NULL;
+	guint window = 0;
+	unsigned long long received = _sim_stamp_pop(slot);
+	LOGE("event(%s) receive with status[%d] on slot %d", TAPI_NOTI_SIM_STATUS, *status, slot->index);
+
+	/* A card is only swapped through a status other than INIT_COMPLETED, so
+	 * a repeated INIT_COMPLETED keeps the identity cache. A swap reported
+	 * by card_changed alone is caught by _sim_cache_check_card(). */
+	state = _convert_card_status_to_sim_state(*status);
+	if (state != SIM_STATE_AVAILABLE) {
+		_sim_cache_invalidate(slot);
+		g_atomic_int_set(&slot->persist_state, SIM_PERSIST_UNCHECKED);
+	}
+	_sim_state_mirror_update(slot, state, TRUE);
+	_sim_event_push(slot, state);
+
+	/* On the raw status, not the debounced or deduplicated delivery, so that
+	 * the cache dropped by a burst is refilled when the burst ends. */
+	if (state == SIM_STATE_AVAILABLE && g_atomic_int_get(&slot->prefetch))
+		_sim_prefetch(slot);
+
+	window = g_atomic_int_get(&debounce_msec);
+	if (window == 0) {
+		_sim_deliver_state(slot, state, received);
+		return;
+	}
+
+	/* The first status of a burst opens the window, the last one before it
+	 * closes is delivered. */
+	G_LOCK(state_listeners);
+	slot->pending_state = state;
+	slot->pending_received = received;
+	if (slot->debounce_source == NULL) {
+		current = g_main_current_source();
+		slot->debounce_source = g_timeout_source_new(window);
+		g_source_set_callback(slot->debounce_source, _sim_debounce_expired, slot, NULL);
+		g_source_attach(slot->debounce_source, current != NULL ? g_source_get_context(current) : NULL);
+	}
+	G_UNLOCK(state_listeners);
+}
+
+/* libtapi dispatches a notification to the thread default context of its
+ * subscriber, so the first listener of a slot subscribes in the thread
+ * which is to dispatch it. */
+/* Takes one reference on the TAPI_NOTI_SIM_STATUS subscription of @slot,
+ * subscribing on the first one. */
+static int _sim_subscribe_locked(sim_slot *slot)
+{
+	struct tapi_handle *th = NULL;
+	int ret = TAPI_API_SUCCESS;
+
+	if (slot->subscriber_count > 0) {
+		slot->subscriber_count++;
+		return SIM_ERROR_NONE;
+	}
+
+	th = _sim_handle_acquire(slot);
+	if (th != NULL) {
+		SIM_IPC_BEGIN("tel_register_noti_event", begin);
+		ret = tel_register_noti_event(th, TAPI_NOTI_SIM_STATUS, on_noti_sim_status, slot);
+		SIM_IPC_END(SIM_STAT_TEL_REGISTER_NOTI_EVENT, "tel_register_noti_event", begin, ret);
+	}
+	if (th == NULL || ret != TAPI_API_SUCCESS) {
+		if (th != NULL)
+			_sim_handle_release(slot, th);
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+	slot->ghandle = th;
+	slot->subscriber_count = 1;
+
+	/* Changes made before the subscription went unnoticed. */
+	_sim_cache_invalidate(slot);
+	g_atomic_int_set(&slot->status_watched, 1);
+	g_atomic_int_set(&slot->state_mirror, SIM_MIRROR_UNKNOWN);
+
+	if (SIM_STATS_ENABLED) {
+		g_atomic_int_set(&slot->status_stamps.head, g_atomic_int_get(&slot->status_stamps.tail));
+		g_atomic_int_set(&slot->status_path, (gint) g_quark_from_string(th->path));
+		slot->status_filter_id = g_dbus_connection_add_filter(th->dbus_connection,
+				_sim_status_filter, slot, NULL);
+	}
+	return SIM_ERROR_NONE;
+}
+
+/* Drops one reference taken by _sim_subscribe_locked(). */
+static int _sim_unsubscribe_locked(sim_slot *slot)
+{
+	int ret = TAPI_API_SUCCESS;
+
+	if (--slot->subscriber_count > 0)
+		return SIM_ERROR_NONE;
+
+	g_atomic_int_set(&slot->status_watched, 0);
+	g_atomic_int_set(&slot->state_mirror, SIM_MIRROR_UNWATCHED);
+	if (slot->status_filter_id != 0) {
+		g_dbus_connection_remove_filter(slot->ghandle->dbus_connection, slot->status_filter_id);
+		slot->status_filter_id = 0;
+	}
+	SIM_IPC_BEGIN("tel_deregister_noti_event", begin);
+	ret = tel_deregister_noti_event(slot->ghandle, TAPI_NOTI_SIM_STATUS);
+	SIM_IPC_END(SIM_STAT_TEL_DEREGISTER_NOTI_EVENT, "tel_deregister_noti_event", begin, ret);
+	_sim_handle_release(slot, slot->ghandle);
+	slot->ghandle = NULL;
+
+	/* Nothing is tracked any more, the next listener starts afresh. */
+	slot->last_state = SIM_STATE_NONE;
+	if (slot->debounce_source != NULL) {
+		g_source_destroy(slot->debounce_source);
+		g_source_unref(slot->debounce_source);
+		slot->debounce_source = NULL;
+	}
+	return ret == TAPI_API_SUCCESS ? SIM_ERROR_NONE : SIM_ERROR_OPERATION_FAILED;
+}
+
+/* A NULL @callback adds no listener and only holds the subscription of
+ * @slot, for the library's own watchers; _sim_unwatch_slot() releases it. */
+static int _sim_add_state_listener_here(sim_slot *slot, gboolean with_slot, void *callback, void *user_data, int *id)
+{
+	sim_cb_data *ccb = NULL;
+	int error_code = SIM_ERROR_NONE;
+
+	if (callback != NULL) {
+		ccb = (sim_cb_data*) calloc(sizeof(sim_cb_data), 1);
+		if (ccb == NULL) {
+			LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+			return SIM_ERROR_OUT_OF_MEMORY;
+		}
+		ccb->slot = slot;
+		ccb->with_slot = with_slot;
+		ccb->cb = callback;
+		ccb->user_data = user_data;
+	}
+
+	G_LOCK(state_listeners);
+	error_code = _sim_subscribe_locked(slot);
+	if (error_code != SIM_ERROR_NONE || ccb == NULL) {
+		G_UNLOCK(state_listeners);
+		free(ccb);
+		return error_code;
+	}
+
+	if (state_listeners == NULL)
+		state_listeners = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free);
+	ccb->th = slot->ghandle;
+	ccb->previous_state = slot->last_state;
+	slot->listener_count++;
+	*id = next_listener_id++;
+	g_hash_table_insert(state_listeners, GINT_TO_POINTER(*id), ccb);
+	G_UNLOCK(state_listeners);
+	return SIM_ERROR_NONE;
+}
+
+typedef struct sim_listener_call {
+	sim_slot *slot;
+	gboolean with_slot;
+	void *callback;
+	void *user_data;
+	int *id;
+	int result;
+	gboolean done;
+	GMutex mutex;
+	GCond cond;
+} sim_listener_call;
+
+static gboolean _sim_add_state_listener_call(gpointer data)
+{
+	sim_listener_call *call = data;
+	int result = _sim_add_state_listener_here(call->slot, call->with_slot, call->callback,
+			call->user_data, call->id);
+
+	g_mutex_lock(&call->mutex);
+	call->result = result;
+	call->done = TRUE;
+	g_cond_signal(&call->cond);
+	g_mutex_unlock(&call->mutex);
+	return FALSE;
+}
+
+/* Adds the listener from the thread running @context, NULL for the caller's.
+ * The calling thread must hold no lock the callbacks of @context take. */
+static int _sim_add_state_listener_in(GMainContext *context, sim_slot *slot, gboolean with_slot,
+		void *callback, void *user_data, int *id)
+{
+	sim_listener_call call = { slot, with_slot, callback, user_data, id, SIM_ERROR_NONE, FALSE, };
+
+	if (context == NULL || g_main_context_is_owner(context))
+		return _sim_add_state_listener_here(slot, with_slot, callback, user_data, id);
+
+	g_mutex_init(&call.mutex);
+	g_cond_init(&call.cond);
+	g_main_context_invoke_full(context, G_PRIORITY_DEFAULT, _sim_add_state_listener_call, &call, NULL);
+	g_mutex_lock(&call.mutex);
+	while (!call.done)
+		g_cond_wait(&call.cond, &call.mutex);
+	g_mutex_unlock(&call.mutex);
+	g_mutex_clear(&call.mutex);
+	g_cond_clear(&call.cond);
+	return call.result;
+}
+
+static int _sim_add_state_listener(sim_slot *slot, gboolean with_slot, void *callback, void *user_data, int *id)
+{
+	GMainContext *context = NULL;
+
+	if (g_atomic_int_get(&dispatch_mode) == SIM_DISPATCH_WORKER_THREAD)
+		context = _sim_worker_context();
+	return _sim_add_state_listener_in(context, slot, with_slot, callback, user_data, id);
+}
+
+/* Keeps the status of @slot subscribed without a listener, so that
+ * on_noti_sim_status() runs from @context; the library's watchers hook
+ * into it directly, like sim_get_event_fd() with _sim_event_push(). */
+static int _sim_watch_slot_in(GMainContext *context, sim_slot *slot)
+{
+	return _sim_add_state_listener_in(context, slot, FALSE, NULL, NULL, NULL);
+}
+
+static int _sim_unwatch_slot(sim_slot *slot)
+{
+	int error_code = SIM_ERROR_NONE;
+
+	G_LOCK(state_listeners);
+	error_code = _sim_unsubscribe_locked(slot);
+	G_UNLOCK(state_listeners);
+	return error_code;
+}
+
+static int _sim_remove_state_listener(int id)
+{
+	int error_code = SIM_ERROR_NONE;
+	sim_cb_data *ccb = NULL;
+	sim_slot *slot = NULL;
+
+	G_LOCK(state_listeners);
+	if (state_listeners != NULL)
+		ccb = g_hash_table_lookup(state_listeners, GINT_TO_POINTER(id));
+	if (ccb == NULL) {
+		G_UNLOCK(state_listeners);
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+	slot = ccb->slot;
+	g_hash_table_remove(state_listeners, GINT_TO_POINTER(id));
+	slot->listener_count--;
+	error_code = _sim_unsubscribe_locked(slot);
+	G_UNLOCK(state_listeners);
+	return error_code;
+}
+
+static int _sim_add_state_changed_cb(sim_state_changed_cb callback, void *user_data, int *id)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	SIM_CHECK_INPUT_PARAMETER(id);
+
+	return _sim_add_state_listener(&slots[SIM_SLOT_DEFAULT], FALSE, callback, user_data, id);
+}
+
+static int _sim_slot_add_state_changed_cb(int slot, sim_slot_state_changed_cb callback, void *user_data, int *id)
+{
+	SIM_CHECK_INPUT_PARAMETER(callback);
+	SIM_CHECK_INPUT_PARAMETER(id);
+	SIM_CHECK_SLOT(slot);
+
+	return _sim_add_state_listener(&slots[slot], TRUE, callback, user_data, id);
+}
+
+static int _sim_remove_state_changed_cb(int id)
+{
+	return _sim_remove_state_listener(id);
+}
+
+static void on_prefetch_status_reply(GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	sim_async_data *ad = user_data;
+	sim_async_data *field_ad = NULL;
+	GError *gerr = NULL;
+	GVariant *reply = NULL;
+	TelSimCardStatus_t sim_card_state = 0x00;
+	gboolean card_changed = FALSE;
+	int i = 0;
+
+	reply = g_dbus_connection_call_finish((GDBusConnection*) source_object, res, &gerr);
+	if (!reply) {
+		LOGE("g_dbus_conn failed. error (%s)", gerr->message);
+		g_error_free(gerr);
+		_sim_async_complete(ad);
+		return;
+	}
+	g_variant_get(reply, "(ib)", &sim_card_state, &card_changed);
+	g_variant_unref(reply);
+
+	if (_sim_cache_check_card(ad->slot, sim_card_state, card_changed, &ad->generation) != SIM_ERROR_NONE) {
+		_sim_async_complete(ad);
+		return;
+	}
+
+	/* All fields at once; each reply lands in the cache through
+	 * on_value_reply() unless the card changed in between. */
+	for (i = 0; i < SIM_FIELD_MAX; i++) {
+		if (_sim_cache_get_value(ad->slot, i, &ad->value, TRUE)) {
+			_sim_value_clear(&ad->value);
+			continue;
+		}
+		field_ad = (sim_async_data*) calloc(sizeof(sim_async_data), 1);
+		if (field_ad == NULL) {
+			LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+			break;
+		}
+		field_ad->slot = ad->slot;
+		field_ad->field = i;
+		field_ad->generation = ad->generation;
+		field_ad->th = _sim_handle_acquire(ad->slot);
+		if (field_ad->th == NULL) {
+			free(field_ad);
+			break;
+		}
+		g_dbus_connection_call(field_ad->th->dbus_connection, DBUS_TELEPHONY_SERVICE, field_ad->th->path,
+				DBUS_TELEPHONY_SIM_INTERFACE, sim_field_method[i], NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+				g_atomic_int_get(&call_timeout), NULL, on_value_reply, field_ad);
+	}
+	_sim_async_complete(ad);
+}
+
+/* Reads all identity values of @slot into the cache in the background, if
+ * the card is initialized. */
+static void _sim_prefetch(sim_slot *slot)
+{
+	sim_async_data *ad = NULL;
+
+	ad = (sim_async_data*) calloc(sizeof(sim_async_data), 1);
+	if (ad == NULL) {
+		LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+		return;
+	}
+	ad->slot = slot;
+	ad->th = _sim_handle_acquire(slot);
+	if (ad->th == NULL) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		free(ad);
+		return;
+	}
+
+	g_dbus_connection_call(ad->th->dbus_connection, DBUS_TELEPHONY_SERVICE, ad->th->path,
+			DBUS_TELEPHONY_SIM_INTERFACE, "GetInitStatus", NULL, NULL, G_DBUS_CALL_FLAGS_NONE,
+			g_atomic_int_get(&call_timeout), NULL, on_prefetch_status_reply, ad);
+}
+
+/* The card may be initialized already, in which case no status change will
+ * come. */
+static gboolean _sim_prefetch_idle(gpointer user_data)
+{
+	_sim_prefetch(user_data);
+	return FALSE;
+}
+
+static int _sim_enable_prefetch(void)
+{
+	int error_code = SIM_ERROR_NONE;
+	GMainContext *watch_context = NULL;
+	GMainContext *context = NULL;
+	GSource *source = NULL;
+	int count = 0;
+	int i = 0;
+
+	count = _sim_slot_count();
+	if (count == 0) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+
+	if (g_atomic_int_get(&dispatch_mode) == SIM_DISPATCH_WORKER_THREAD)
+		watch_context = _sim_worker_context();
+	context = watch_context != NULL ? g_main_context_ref(watch_context) : g_main_context_ref_thread_default();
+	G_LOCK(prefetch);
+	for (i = 0; i < count; i++) {
+		if (g_atomic_int_get(&slots[i].prefetch))
+			continue;
+		error_code = _sim_watch_slot_in(watch_context, &slots[i]);
+		if (error_code != SIM_ERROR_NONE)
+			break;
+		g_atomic_int_set(&slots[i].prefetch, TRUE);
+		source = g_idle_source_new();
+		g_source_set_callback(source, _sim_prefetch_idle, &slots[i], NULL);
+		g_source_attach(source, context);
+		g_source_unref(source);
+	}
+	G_UNLOCK(prefetch);
+	g_main_context_unref(context);
+	return error_code;
+}
+
+static int _sim_disable_prefetch(void)
+{
+	int i = 0;
+
+	G_LOCK(prefetch);
+	for (i = 0; i < SIM_SLOT_MAX; i++) {
+		if (!g_atomic_int_get(&slots[i].prefetch))
+			continue;
+		g_atomic_int_set(&slots[i].prefetch, FALSE);
+		_sim_unwatch_slot(&slots[i]);
+	}
+	G_UNLOCK(prefetch);
+	return SIM_ERROR_NONE;
+}
+
+/* Subscribes from the worker thread. event_fd is set first, so that no
+ * transition dispatched meanwhile is missed. */
+static int _sim_events_start_locked(void)
+{
+	int error_code = SIM_ERROR_NONE;
+	int count = 0;
+	int fd = -1;
+	int i = 0;
+
+	count = _sim_slot_count();
+	fd = count > 0 ? eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) : -1;
+	if (fd < 0) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+	g_atomic_int_set(&event_fd, fd);
+
+	/* Transitions reach the rings from on_noti_sim_status(). */
+	for (i = 0; i < count; i++) {
+		error_code = _sim_watch_slot_in(_sim_worker_context(), &slots[i]);
+		if (error_code != SIM_ERROR_NONE)
+			break;
+	}
+
+	if (error_code != SIM_ERROR_NONE) {
+		while (i-- > 0)
+			_sim_unwatch_slot(&slots[i]);
+		g_atomic_int_set(&event_fd, -1);
+		close(fd);
+		return error_code;
+	}
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_get_event_fd(int *fd)
+{
+	int error_code = SIM_ERROR_NONE;
+
+	SIM_CHECK_INPUT_PARAMETER(fd);
+
+	G_LOCK(events);
+	if (g_atomic_int_get(&event_fd) < 0)
+		error_code = _sim_events_start_locked();
+	*fd = g_atomic_int_get(&event_fd);
+	G_UNLOCK(events);
+	return error_code;
+}
+
+/* Merges the rings by timestamp. The eventfd is reset before the rings are
+ * read, so a transition pushed meanwhile makes it readable again. */
+static int _sim_read_events(sim_event_s *events, int max_count, int *count)
+{
+	sim_event_ring *ring = NULL;
+	sim_event_ring *next = NULL;
+	guint64 value = 0;
+	int fd = g_atomic_int_get(&event_fd);
+	int i = 0;
+
+	SIM_CHECK_INPUT_PARAMETER(events);
+	SIM_CHECK_INPUT_PARAMETER(count);
+	if (max_count <= 0) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+	*count = 0;
+	if (fd < 0) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+
+	G_LOCK(event_reader);
+	if (read(fd, &value, sizeof(value)) < 0)
+		value = 0;
+	while (*count < max_count) {
+		next = NULL;
+		for (i = 0; i < SIM_SLOT_MAX; i++) {
+			ring = &slots[i].events;
+			if (g_atomic_int_get(&ring->head) == g_atomic_int_get(&ring->tail))
+				continue;
+			if (next == NULL || ring->events[ring->head & (SIM_EVENT_RING_SIZE - 1)].timestamp
+					< next->events[next->head & (SIM_EVENT_RING_SIZE - 1)].timestamp)
+				next = ring;
+		}
+		if (next == NULL)
+			break;
+		events[(*count)++] = next->events[next->head & (SIM_EVENT_RING_SIZE - 1)];
+		g_atomic_int_set(&next->head, next->head + 1);
+	}
+
+	/* Keep the descriptor readable for what did not fit. */
+	value = 1;
+	for (i = 0; i < SIM_SLOT_MAX; i++) {
+		ring = &slots[i].events;
+		if (g_atomic_int_get(&ring->head) != g_atomic_int_get(&ring->tail)) {
+			if (write(fd, &value, sizeof(value)) < 0)
+				LOGE("[%s] write failed", __FUNCTION__);
+			break;
+		}
+	}
+	G_UNLOCK(event_reader);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_set_dispatch_mode(sim_dispatch_mode_e mode)
+{
+	if (mode != SIM_DISPATCH_CALLER_CONTEXT && mode != SIM_DISPATCH_WORKER_THREAD) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+	g_atomic_int_set(&dispatch_mode, mode);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_set_identity_cache_file(const char *path)
+{
+	return _sim_persist_open(path);
+}
+
+/* Only the file is read, so the slot is not checked against the modems
+ * telephony reports, which may not be up yet. */
+static int _sim_get_last_known_snapshot(int slot, sim_snapshot_s *snapshot, bool *stale)
+{
+	sim_persist_identity identity;
+	int error_code = SIM_ERROR_NONE;
+	gint persist_state = SIM_PERSIST_UNCHECKED;
+	gint state = SIM_MIRROR_UNWATCHED;
+
+	SIM_CHECK_INPUT_PARAMETER(snapshot);
+	SIM_CHECK_INPUT_PARAMETER(stale);
+	if (slot < 0 || slot >= SIM_SLOT_MAX) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+	memset(snapshot, 0, sizeof(sim_snapshot_s));
+	snapshot->state = SIM_STATE_UNKNOWN;
+
+	/* Read the check state first: a record read after it may only be
+	 * fresher than what it says. Unwatched, a new card may have been
+	 * swapped again since it was checked, see _sim_persist_check_card(). */
+	persist_state = g_atomic_int_get(&slots[slot].persist_state);
+	*stale = persist_state == SIM_PERSIST_UNCHECKED
+			|| (persist_state == SIM_PERSIST_REPLACING && !g_atomic_int_get(&slots[slot].status_watched));
+	error_code = _sim_persist_read(slot, &identity);
+	if (error_code != SIM_ERROR_NONE)
+		return error_code;
+
+	memcpy(&snapshot->imsi_info, &identity.imsi_info, sizeof(sim_imsi_info_s));
+	error_code = _sim_copy_optional_string(identity.icc_id, &snapshot->icc_id);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(identity.spn, &snapshot->spn);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(identity.cphs_full_name, &snapshot->cphs_full_name);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(identity.cphs_short_name, &snapshot->cphs_short_name);
+	if (error_code == SIM_ERROR_NONE)
+		error_code = _sim_copy_optional_string(identity.subscriber_number, &snapshot->subscriber_number);
+	if (error_code != SIM_ERROR_NONE) {
+		_sim_release_snapshot(snapshot);
+		return error_code;
+	}
+
+	state = g_atomic_int_get(&slots[slot].state_mirror);
+	if (state >= 0)
+		snapshot->state = state;
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_set_state_changed_debounce_time(unsigned int msec)
+{
+	g_atomic_int_set(&debounce_msec, msec);
+	return SIM_ERROR_NONE;
+}
+
+static int _sim_set_state_changed_cb(sim_state_changed_cb sim_cb, void* user_data)
+{
+	int error_code = SIM_ERROR_NONE;
+	int id = 0;
+
+	SIM_CHECK_INPUT_PARAMETER(sim_cb);
+
+	error_code = _sim_add_state_listener(&slots[SIM_SLOT_DEFAULT], FALSE, sim_cb, user_data, &id);
+	if (error_code != SIM_ERROR_NONE)
+		return error_code;
+
+	G_LOCK(state_listeners);
+	legacy_listener_ids = g_slist_prepend(legacy_listener_ids, GINT_TO_POINTER(id));
+	G_UNLOCK(state_listeners);
+	return SIM_ERROR_NONE;
+}
+
+/* Removes every listener added with sim_set_state_changed_cb(). */
+static int _sim_unset_state_changed_cb()
+{
+	int error_code = SIM_ERROR_NONE;
+	GSList *ids = NULL;
+	GSList *l = NULL;
+
+	G_LOCK(state_listeners);
+	ids = legacy_listener_ids;
+	legacy_listener_ids = NULL;
+	G_UNLOCK(state_listeners);
+
+	if (ids == NULL) {
+		LOGE("[%s] OPERATION_FAILED(0x%08x)", __FUNCTION__, SIM_ERROR_OPERATION_FAILED);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+	for (l = ids; l != NULL; l = l->next) {
+		if (_sim_remove_state_listener(GPOINTER_TO_INT(l->data)) != SIM_ERROR_NONE)
+			error_code = SIM_ERROR_OPERATION_FAILED;
+	}
+	g_slist_free(ids);
+	return error_code;
+}
+
+/* Public entry points, counted for sim_get_stats() */
+
+int sim_get_icc_id(char **icc_id)
+{
+	SIM_API_RETURN(SIM_STAT_GET_ICC_ID, _sim_get_icc_id(icc_id));
+}
+
+int sim_get_icc_id_r(char *icc_id, size_t len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_ICC_ID_R, _sim_get_icc_id_r(icc_id, len));
+}
+
+int sim_get_icc_id_async(sim_get_string_cb callback, void *user_data)
+{
+	SIM_API_RETURN(SIM_STAT_GET_ICC_ID_ASYNC, _sim_get_icc_id_async(callback, user_data));
+}
+
+int sim_get_imsi_info(sim_imsi_info_s *imsi_info)
+{
+	SIM_API_RETURN(SIM_STAT_GET_IMSI_INFO, _sim_get_imsi_info(imsi_info));
+}
+
+int sim_get_imsi_info_async(sim_get_imsi_info_cb callback, void *user_data)
+{
+	SIM_API_RETURN(SIM_STAT_GET_IMSI_INFO_ASYNC, _sim_get_imsi_info_async(callback, user_data));
+}
+
+int sim_get_mcc(char **mcc)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MCC, _sim_get_mcc(mcc));
+}
+
+int sim_get_mcc_r(char *mcc, size_t len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MCC_R, _sim_get_mcc_r(mcc, len));
+}
+
+int sim_get_mnc(char **mnc)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MNC, _sim_get_mnc(mnc));
+}
+
+int sim_get_mnc_r(char *mnc, size_t len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MNC_R, _sim_get_mnc_r(mnc, len));
+}
+
+int sim_get_msin(char **msin)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MSIN, _sim_get_msin(msin));
+}
+
+int sim_get_msin_r(char *msin, size_t len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MSIN_R, _sim_get_msin_r(msin, len));
+}
+
+int sim_get_spn(char **spn)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SPN, _sim_get_spn(spn));
+}
+
+int sim_get_spn_r(char *spn, size_t len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SPN_R, _sim_get_spn_r(spn, len));
+}
+
+int sim_get_spn_async(sim_get_string_cb callback, void *user_data)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SPN_ASYNC, _sim_get_spn_async(callback, user_data));
+}
+
+int sim_get_cphs_operator_name(char** full_name, char** short_name)
+{
+	SIM_API_RETURN(SIM_STAT_GET_CPHS_OPERATOR_NAME, _sim_get_cphs_operator_name(full_name, short_name));
+}
+
+int sim_get_cphs_operator_name_r(char *full_name, size_t full_len, char *short_name, size_t short_len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_CPHS_OPERATOR_NAME_R, _sim_get_cphs_operator_name_r(full_name, full_len, short_name, short_len));
+}
+
+int sim_get_cphs_operator_name_async(sim_get_cphs_operator_name_cb callback, void *user_data)
+{
+	SIM_API_RETURN(SIM_STAT_GET_CPHS_OPERATOR_NAME_ASYNC, _sim_get_cphs_operator_name_async(callback, user_data));
+}
+
+int sim_get_state(sim_state_e *sim_state)
+{
+	SIM_API_RETURN(SIM_STAT_GET_STATE, _sim_get_state(sim_state));
+}
+
+int sim_get_subscriber_number(char **subscriber_number)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SUBSCRIBER_NUMBER, _sim_get_subscriber_number(subscriber_number));
+}
+
+int sim_get_subscriber_number_r(char *subscriber_number, size_t len)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SUBSCRIBER_NUMBER_R, _sim_get_subscriber_number_r(subscriber_number, len));
+}
+
+int sim_get_subscriber_number_async(sim_get_string_cb callback, void *user_data)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SUBSCRIBER_NUMBER_ASYNC, _sim_get_subscriber_number_async(callback, user_data));
+}
+
+int sim_get_msisdn_list(sim_msisdn_list_h *list)
+{
+	SIM_API_RETURN(SIM_STAT_GET_MSISDN_LIST, _sim_get_msisdn_list(list));
+}
+
+int sim_msisdn_list_get_count(sim_msisdn_list_h list, int *count)
+{
+	SIM_API_RETURN(SIM_STAT_MSISDN_LIST_GET_COUNT, _sim_msisdn_list_get_count(list, count));
+}
+
+int sim_msisdn_list_get_at(sim_msisdn_list_h list, int index, const char **number, const char **name)
+{
+	SIM_API_RETURN(SIM_STAT_MSISDN_LIST_GET_AT, _sim_msisdn_list_get_at(list, index, number, name));
+}
+
+int sim_msisdn_list_destroy(sim_msisdn_list_h list)
+{
+	SIM_API_RETURN(SIM_STAT_MSISDN_LIST_DESTROY, _sim_msisdn_list_destroy(list));
+}
+
+void sim_release_snapshot(sim_snapshot_s *snapshot)
+{
+	SIM_TRACE_API_ENTRY(__func__);
+	SIM_STATS_BEGIN(begin);
+	_sim_release_snapshot(snapshot);
+	SIM_STATS_END(SIM_STAT_RELEASE_SNAPSHOT, begin, SIM_ERROR_NONE);
+	SIM_TRACE_API_RETURN(__func__, SIM_ERROR_NONE);
+}
+
+int sim_get_snapshot(sim_snapshot_s *snapshot)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SNAPSHOT, _sim_get_snapshot(snapshot));
+}
+
+int sim_add_state_changed_cb(sim_state_changed_cb callback, void *user_data, int *id)
+{
+	SIM_API_RETURN(SIM_STAT_ADD_STATE_CHANGED_CB, _sim_add_state_changed_cb(callback, user_data, id));
+}
+
+int sim_remove_state_changed_cb(int id)
+{
+	SIM_API_RETURN(SIM_STAT_REMOVE_STATE_CHANGED_CB, _sim_remove_state_changed_cb(id));
+}
+
+int sim_set_state_changed_debounce_time(unsigned int msec)
+{
+	SIM_API_RETURN(SIM_STAT_SET_STATE_CHANGED_DEBOUNCE_TIME, _sim_set_state_changed_debounce_time(msec));
+}
+
+int sim_set_state_changed_cb(sim_state_changed_cb callback, void *user_data)
+{
+	SIM_API_RETURN(SIM_STAT_SET_STATE_CHANGED_CB, _sim_set_state_changed_cb(callback, user_data));
+}
+
+int sim_unset_state_changed_cb()
+{
+	SIM_API_RETURN(SIM_STAT_UNSET_STATE_CHANGED_CB, _sim_unset_state_changed_cb());
+}
+
+int sim_get_icc_id_timed(char **icc_id, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_ICC_ID_TIMED, _sim_get_icc_id_timed(SIM_SLOT_DEFAULT, icc_id, timeout_ms, cancellable));
+}
+
+int sim_get_imsi_info_timed(sim_imsi_info_s *imsi_info, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_IMSI_INFO_TIMED, _sim_get_imsi_info_timed(SIM_SLOT_DEFAULT, imsi_info, timeout_ms, cancellable));
+}
+
+int sim_get_spn_timed(char **spn, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SPN_TIMED, _sim_get_spn_timed(SIM_SLOT_DEFAULT, spn, timeout_ms, cancellable));
+}
+
+int sim_get_cphs_operator_name_timed(char **full_name, char **short_name, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_CPHS_OPERATOR_NAME_TIMED,
+			_sim_get_cphs_operator_name_timed(SIM_SLOT_DEFAULT, full_name, short_name, timeout_ms, cancellable));
+}
+
+int sim_get_state_timed(sim_state_e *sim_state, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_STATE_TIMED, _sim_get_state_timed(SIM_SLOT_DEFAULT, sim_state, timeout_ms, cancellable));
+}
+
+int sim_get_subscriber_number_timed(char **subscriber_number, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SUBSCRIBER_NUMBER_TIMED,
+			_sim_get_subscriber_number_timed(SIM_SLOT_DEFAULT, subscriber_number, timeout_ms, cancellable));
+}
+
+int sim_get_snapshot_timed(sim_snapshot_s *snapshot, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SNAPSHOT_TIMED, _sim_get_snapshot_timed(SIM_SLOT_DEFAULT, snapshot, timeout_ms, cancellable));
+}
+
+int sim_set_timeout(int timeout_ms)
+{
+	SIM_API_RETURN(SIM_STAT_SET_TIMEOUT, _sim_set_timeout(timeout_ms));
+}
+
+int sim_get_timeout(int *timeout_ms)
+{
+	SIM_API_RETURN(SIM_STAT_GET_TIMEOUT, _sim_get_timeout(timeout_ms));
+}
+
+int sim_cancellable_create(sim_cancellable_h *cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_CANCELLABLE_CREATE, _sim_cancellable_create(cancellable));
+}
+
+int sim_cancellable_cancel(sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_CANCELLABLE_CANCEL, _sim_cancellable_cancel(cancellable));
+}
+
+int sim_cancellable_reset(sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_CANCELLABLE_RESET, _sim_cancellable_reset(cancellable));
+}
+
+int sim_cancellable_destroy(sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_CANCELLABLE_DESTROY, _sim_cancellable_destroy(cancellable));
+}
+
+int sim_get_slot_count(int *count)
+{
+	SIM_API_RETURN(SIM_STAT_GET_SLOT_COUNT, _sim_get_slot_count(count));
+}
+
+int sim_slot_get_icc_id(int slot, char **icc_id)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_ICC_ID, _sim_slot_get_icc_id(slot, icc_id));
+}
+
+int sim_slot_get_imsi_info(int slot, sim_imsi_info_s *imsi_info)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_IMSI_INFO, _sim_slot_get_imsi_info(slot, imsi_info));
+}
+
+int sim_slot_get_spn(int slot, char **spn)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_SPN, _sim_slot_get_spn(slot, spn));
+}
+
+int sim_slot_get_cphs_operator_name(int slot, char **full_name, char **short_name)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_CPHS_OPERATOR_NAME, _sim_slot_get_cphs_operator_name(slot, full_name, short_name));
+}
+
+int sim_slot_get_state(int slot, sim_state_e *sim_state)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_STATE, _sim_slot_get_state(slot, sim_state));
+}
+
+int sim_slot_get_subscriber_number(int slot, char **subscriber_number)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_SUBSCRIBER_NUMBER, _sim_slot_get_subscriber_number(slot, subscriber_number));
+}
+
+int sim_slot_get_snapshot(int slot, sim_snapshot_s *snapshot)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_GET_SNAPSHOT, _sim_slot_get_snapshot(slot, snapshot));
+}
+
+int sim_slot_add_state_changed_cb(int slot, sim_slot_state_changed_cb callback, void *user_data, int *id)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_ADD_STATE_CHANGED_CB, _sim_slot_add_state_changed_cb(slot, callback, user_data, id));
+}
+
+int sim_get_all_snapshots(sim_snapshot_s *snapshots, int max_count, int *count)
+{
+	SIM_API_RETURN(SIM_STAT_GET_ALL_SNAPSHOTS, _sim_get_all_snapshots(snapshots, max_count, count));
+}
+
+int sim_enable_prefetch(void)
+{
+	SIM_API_RETURN(SIM_STAT_ENABLE_PREFETCH, _sim_enable_prefetch());
+}
+
+int sim_disable_prefetch(void)
+{
+	SIM_API_RETURN(SIM_STAT_DISABLE_PREFETCH, _sim_disable_prefetch());
+}
+
+int sim_set_identity_cache_file(const char *path)
+{
+	SIM_API_RETURN(SIM_STAT_SET_IDENTITY_CACHE_FILE, _sim_set_identity_cache_file(path));
+}
+
+int sim_get_last_known_snapshot(int slot, sim_snapshot_s *snapshot, bool *stale)
+{
+	SIM_API_RETURN(SIM_STAT_GET_LAST_KNOWN_SNAPSHOT, _sim_get_last_known_snapshot(slot, snapshot, stale));
+}
+
+int sim_set_optimistic_mode(bool enable)
+{
+	SIM_API_RETURN(SIM_STAT_SET_OPTIMISTIC_MODE, _sim_set_optimistic_mode(enable));
+}
+
+int sim_read_files(const sim_file_s *files, int count, unsigned char *buffer, size_t len, sim_file_result_s *results)
+{
+	SIM_API_RETURN(SIM_STAT_READ_FILES, _sim_read_files(files, count, buffer, len, results));
+}
+
+int sim_slot_read_files(int slot, const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results)
+{
+	SIM_API_RETURN(SIM_STAT_SLOT_READ_FILES, _sim_slot_read_files(slot, files, count, buffer, len, results));
+}
+
+int sim_read_files_timed(const sim_file_s *files, int count, unsigned char *buffer, size_t len,
+		sim_file_result_s *results, int timeout_ms, sim_cancellable_h cancellable)
+{
+	SIM_API_RETURN(SIM_STAT_READ_FILES_TIMED, _sim_read_files_timed(SIM_SLOT_DEFAULT, files, count, buffer, len,
+			results, timeout_ms, cancellable));
+}
+
+int sim_lookup_operator(const char *mcc, const char *mnc, const char **country, const char **name)
+{
+	SIM_API_RETURN(SIM_STAT_LOOKUP_OPERATOR, _sim_lookup_operator(mcc, mnc, country, name));
+}
+
+int sim_get_home_operator_info(sim_home_operator_info_s *info)
+{
+	SIM_API_RETURN(SIM_STAT_GET_HOME_OPERATOR_INFO, _sim_get_home_operator_info(info));
+}
+
+int sim_get_event_fd(int *fd)
+{
+	SIM_API_RETURN(SIM_STAT_GET_EVENT_FD, _sim_get_event_fd(fd));
+}
+
+int sim_read_events(sim_event_s *events, int max_count, int *count)
+{
+	SIM_API_RETURN(SIM_STAT_READ_EVENTS, _sim_read_events(events, max_count, count));
+}
+
+int sim_set_dispatch_mode(sim_dispatch_mode_e mode)
+{
+	SIM_API_RETURN(SIM_STAT_SET_DISPATCH_MODE, _sim_set_dispatch_mode(mode));
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sim.h>
+#include <sim_operator_private.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef struct
+{
+	uint32_t key;
+	const char *country;
+} sim_country_entry;
+
+typedef struct
+{
+	uint32_t key;
+	const char *country;
+	const char *name;
+} sim_operator_entry;
+
+/* Generated at build time, see tools/gen-operator-table.py. */
+#include "sim_operator_table.h"
+
+/* Same as hash() of the generator. */
+static uint32_t _sim_operator_hash(uint32_t key, uint32_t seed)
+{
+	uint32_t h = key + seed * 0x9e3779b9u;
+
+	h ^= h >> 16;
+	h *= 0x7feb352du;
+	h ^= h >> 15;
+	h *= 0x846ca68bu;
+	h ^= h >> 16;
+	return h;
+}
+
+/* Returns -1 unless @str is @min to @max decimal digits. */
+static int _sim_operator_parse(const char *str, size_t min, size_t max, uint32_t *value)
+{
+	size_t len = 0;
+
+	*value = 0;
+	for (len = 0; str[len] != '\0'; len++) {
+		if (len == max || str[len] < '0' || str[len] > '9')
+			return -1;
+		*value = *value * 10 + (str[len] - '0');
+	}
+	return len < min ? -1 : (int) len;
+}
+
+/* Both tables are looked up the same way: the bucket of the key gives the
+ * displacement, which gives the only slot the key can be in. */
+static const sim_country_entry *_sim_country_slot(uint32_t key)
+{
+	uint32_t d = sim_country_displacements[_sim_operator_hash(key, 0) & (SIM_COUNTRY_BUCKETS - 1)];
+
+	return &sim_country_slots[_sim_operator_hash(key, d) & (SIM_COUNTRY_SLOTS - 1)];
+}
+
+static const sim_operator_entry *_sim_operator_slot(uint32_t key)
+{
+	uint32_t d = sim_operator_displacements[_sim_operator_hash(key, 0) & (SIM_OPERATOR_BUCKETS - 1)];
+
+	return &sim_operator_slots[_sim_operator_hash(key, d) & (SIM_OPERATOR_SLOTS - 1)];
+}
+
+int _sim_operator_lookup(const char *mcc, const char *mnc, const char **country, const char **name)
+{
+	const sim_country_entry *country_entry = NULL;
+	const sim_operator_entry *operator_entry = NULL;
+	uint32_t mcc_value = 0;
+	uint32_t mnc_value = 0;
+	uint32_t key = 0;
+	int mnc_len = 0;
+
+	*country = NULL;
+	if (name != NULL)
+		*name = NULL;
+	if (_sim_operator_parse(mcc, 3, 3, &mcc_value) < 0)
+		return SIM_ERROR_NOT_AVAILABLE;
+
+	country_entry = _sim_country_slot(mcc_value);
+	if (country_entry->key != mcc_value || country_entry->country == NULL)
+		return SIM_ERROR_NOT_AVAILABLE;
+	*country = country_entry->country;
+
+	if (mnc == NULL || name == NULL)
+		return SIM_ERROR_NONE;
+	mnc_len = _sim_operator_parse(mnc, 2, 3, &mnc_value);
+	if (mnc_len < 0)
+		return SIM_ERROR_NONE;
+
+	/* Encoded as by the generator, "05" and "005" are different MNCs. */
+	key = mcc_value * 10000 + (mnc_len == 3 ? 1000 : 0) + mnc_value;
+	operator_entry = _sim_operator_slot(key);
+	if (operator_entry->key == key && operator_entry->name != NULL)
+		*name = operator_entry->name;
+	return SIM_ERROR_NONE;
+}
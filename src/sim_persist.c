@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sim.h>
+#include <sim_persist_private.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <dlog.h>
+
+#include <glib.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_SIM"
+
+#define SIM_PERSIST_MAGIC	0x53494d43	/* "SIMC" */
+#define SIM_PERSIST_VERSION	1
+
+/* Reads give up after this many writes raced with them. */
+#define SIM_PERSIST_READ_RETRIES	100
+
+/* sequence is odd while the record is being written, so that readers in
+ * other processes mapping the same file can detect a torn copy. */
+typedef struct
+{
+	unsigned int sequence;
+	sim_persist_identity identity;
+} sim_persist_record;
+
+typedef struct
+{
+	unsigned int magic;
+	unsigned int version;
+	sim_persist_record records[SIM_PERSIST_SLOT_MAX];
+} sim_persist_file;
+
+/* The mapping and its descriptor, which writers flock() against writers
+ * of other processes. */
+static sim_persist_file *persist_map = NULL;
+static int persist_fd = -1;
+G_LOCK_DEFINE_STATIC(persist);
+
+#define SIM_PERSIST_SEQ_LOAD(var)	__atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define SIM_PERSIST_SEQ_INC(var)	__atomic_add_fetch(&(var), 1, __ATOMIC_RELEASE)
+
+static void _sim_persist_write_begin(sim_persist_record *record)
+{
+	flock(persist_fd, LOCK_EX);
+	SIM_PERSIST_SEQ_INC(record->sequence);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void _sim_persist_write_end(sim_persist_record *record)
+{
+	SIM_PERSIST_SEQ_INC(record->sequence);
+	flock(persist_fd, LOCK_UN);
+}
+
+/* A file of another layout is reset; a record left odd by a writer which
+ * died is dropped. */
+static void _sim_persist_check_file(sim_persist_file *map)
+{
+	int i = 0;
+
+	flock(persist_fd, LOCK_EX);
+	if (map->magic != SIM_PERSIST_MAGIC || map->version != SIM_PERSIST_VERSION) {
+		memset(map, 0, sizeof(sim_persist_file));
+		map->magic = SIM_PERSIST_MAGIC;
+		map->version = SIM_PERSIST_VERSION;
+	}
+	for (i = 0; i < SIM_PERSIST_SLOT_MAX; i++) {
+		if (map->records[i].sequence & 1) {
+			memset(&map->records[i].identity, 0, sizeof(sim_persist_identity));
+			map->records[i].sequence++;
+		}
+	}
+	flock(persist_fd, LOCK_UN);
+}
+
+static void _sim_persist_close_locked(void)
+{
+	if (persist_map != NULL)
+		munmap(persist_map, sizeof(sim_persist_file));
+	if (persist_fd >= 0)
+		close(persist_fd);
+	persist_map = NULL;
+	persist_fd = -1;
+}
+
+int _sim_persist_open(const char *path)
+{
+	struct stat st;
+	void *map = NULL;
+
+	G_LOCK(persist);
+	_sim_persist_close_locked();
+	if (path == NULL) {
+		G_UNLOCK(persist);
+		return SIM_ERROR_NONE;
+	}
+
+	persist_fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+	if (persist_fd < 0 || fstat(persist_fd, &st) < 0
+			|| (st.st_size != sizeof(sim_persist_file) && ftruncate(persist_fd, sizeof(sim_persist_file)) < 0)) {
+		LOGE("[%s] cannot open %s", __FUNCTION__, path);
+		_sim_persist_close_locked();
+		G_UNLOCK(persist);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+
+	map = mmap(NULL, sizeof(sim_persist_file), PROT_READ | PROT_WRITE, MAP_SHARED, persist_fd, 0);
+	if (map == MAP_FAILED) {
+		LOGE("[%s] cannot map %s", __FUNCTION__, path);
+		_sim_persist_close_locked();
+		G_UNLOCK(persist);
+		return SIM_ERROR_OPERATION_FAILED;
+	}
+	persist_map = map;
+	_sim_persist_check_file(persist_map);
+	G_UNLOCK(persist);
+	return SIM_ERROR_NONE;
+}
+
+int _sim_persist_read(int slot, sim_persist_identity *identity)
+{
+	sim_persist_record *record = NULL;
+	unsigned int sequence = 0;
+	int i = 0;
+
+	if (slot < 0 || slot >= SIM_PERSIST_SLOT_MAX)
+		return SIM_ERROR_NOT_AVAILABLE;
+
+	G_LOCK(persist);
+	if (persist_map == NULL) {
+		G_UNLOCK(persist);
+		return SIM_ERROR_NOT_AVAILABLE;
+	}
+
+	record = &persist_map->records[slot];
+	for (i = 0; i < SIM_PERSIST_READ_RETRIES; i++) {
+		sequence = SIM_PERSIST_SEQ_LOAD(record->sequence);
+		if (sequence & 1)
+			continue;
+		memcpy(identity, &record->identity, sizeof(sim_persist_identity));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (SIM_PERSIST_SEQ_LOAD(record->sequence) == sequence)
+			break;
+	}
+	G_UNLOCK(persist);
+
+	if (i == SIM_PERSIST_READ_RETRIES || identity->valid == 0)
+		return SIM_ERROR_NOT_AVAILABLE;
+
+	/* The file may have been written by anyone, never trust its strings. */
+	identity->icc_id[SIM_PERSIST_ICC_ID_LEN] = '\0';
+	identity->imsi_info.mcc[SIM_MCC_LEN] = '\0';
+	identity->imsi_info.mnc[SIM_MNC_LEN] = '\0';
+	identity->imsi_info.msin[SIM_MSIN_LEN] = '\0';
+	identity->spn[SIM_PERSIST_SPN_LEN] = '\0';
+	identity->cphs_full_name[SIM_PERSIST_CPHS_FULL_LEN] = '\0';
+	identity->cphs_short_name[SIM_PERSIST_CPHS_SHORT_LEN] = '\0';
+	identity->subscriber_number[SIM_PERSIST_MSISDN_LEN] = '\0';
+	return SIM_ERROR_NONE;
+}
+
+/* A value which does not fit is left out rather than stored truncated. */
+static int _sim_persist_copy(char *dest, size_t len, const char *src)
+{
+	if (g_strlcpy(dest, src != NULL ? src : "", len) >= len) {
+		dest[0] = '\0';
+		return -1;
+	}
+	return 0;
+}
+
+void _sim_persist_store(int slot, sim_persist_field_e field, const char *str, const char *str2,
+		const sim_imsi_info_s *imsi)
+{
+	sim_persist_identity *identity = NULL;
+	sim_persist_record *record = NULL;
+	int ret = 0;
+
+	if (slot < 0 || slot >= SIM_PERSIST_SLOT_MAX || g_atomic_pointer_get(&persist_map) == NULL)
+		return;
+
+	G_LOCK(persist);
+	if (persist_map == NULL) {
+		G_UNLOCK(persist);
+		return;
+	}
+
+	record = &persist_map->records[slot];
+	identity = &record->identity;
+	_sim_persist_write_begin(record);
+	switch (field) {
+		case SIM_PERSIST_ICC_ID:
+			if ((identity->valid & (1 << SIM_PERSIST_ICC_ID))
+					&& strcmp(identity->icc_id, str != NULL ? str : "") != 0)
+				memset(identity, 0, sizeof(sim_persist_identity));
+			ret = _sim_persist_copy(identity->icc_id, sizeof(identity->icc_id), str);
+			break;
+		case SIM_PERSIST_IMSI:
+			memcpy(&identity->imsi_info, imsi, sizeof(sim_imsi_info_s));
+			break;
+		case SIM_PERSIST_SPN:
+			ret = _sim_persist_copy(identity->spn, sizeof(identity->spn), str);
+			break;
+		case SIM_PERSIST_CPHS:
+			ret = _sim_persist_copy(identity->cphs_full_name, sizeof(identity->cphs_full_name), str);
+			if (ret == 0)
+				ret = _sim_persist_copy(identity->cphs_short_name, sizeof(identity->cphs_short_name), str2);
+			break;
+		case SIM_PERSIST_MSISDN:
+			ret = _sim_persist_copy(identity->subscriber_number, sizeof(identity->subscriber_number), str);
+			break;
+		default:
+			ret = -1;
+			break;
+	}
+	if (ret == 0)
+		identity->valid |= 1 << field;
+	else
+		identity->valid &= ~(1 << field);
+	_sim_persist_write_end(record);
+	G_UNLOCK(persist);
+}
+
+void _sim_persist_forget(int slot)
+{
+	sim_persist_record *record = NULL;
+
+	if (slot < 0 || slot >= SIM_PERSIST_SLOT_MAX || g_atomic_pointer_get(&persist_map) == NULL)
+		return;
+
+	G_LOCK(persist);
+	if (persist_map != NULL) {
+		record = &persist_map->records[slot];
+		_sim_persist_write_begin(record);
+		memset(&record->identity, 0, sizeof(sim_persist_identity));
+		_sim_persist_write_end(record);
+	}
+	G_UNLOCK(persist);
+}
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ * Licensed under the Apache License, Version 2.0 (the License);
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sim.h>
+#include <sim_stats_private.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_SIM"
+
+#ifdef SIM_ENABLE_STATS
+
+static const char *sim_stat_name[SIM_STAT_MAX] = {
+	[SIM_STAT_GET_ICC_ID] = "sim_get_icc_id",
+	[SIM_STAT_GET_ICC_ID_R] = "sim_get_icc_id_r",
+	[SIM_STAT_GET_ICC_ID_ASYNC] = "sim_get_icc_id_async",
+	[SIM_STAT_GET_IMSI_INFO] = "sim_get_imsi_info",
+	[SIM_STAT_GET_IMSI_INFO_ASYNC] = "sim_get_imsi_info_async",
+	[SIM_STAT_GET_MCC] = "sim_get_mcc",
+	[SIM_STAT_GET_MCC_R] = "sim_get_mcc_r",
+	[SIM_STAT_GET_MNC] = "sim_get_mnc",
+	[SIM_STAT_GET_MNC_R] = "sim_get_mnc_r",
+	[SIM_STAT_GET_MSIN] = "sim_get_msin",
+	[SIM_STAT_GET_MSIN_R] = "sim_get_msin_r",
+	[SIM_STAT_GET_SPN] = "sim_get_spn",
+	[SIM_STAT_GET_SPN_R] = "sim_get_spn_r",
+	[SIM_STAT_GET_SPN_ASYNC] = "sim_get_spn_async",
+	[SIM_STAT_GET_CPHS_OPERATOR_NAME] = "sim_get_cphs_operator_name",
+	[SIM_STAT_GET_CPHS_OPERATOR_NAME_R] = "sim_get_cphs_operator_name_r",
+	[SIM_STAT_GET_CPHS_OPERATOR_NAME_ASYNC] = "sim_get_cphs_operator_name_async",
+	[SIM_STAT_GET_STATE] = "sim_get_state",
+	[SIM_STAT_GET_SUBSCRIBER_NUMBER] = "sim_get_subscriber_number",
+	[SIM_STAT_GET_SUBSCRIBER_NUMBER_R] = "sim_get_subscriber_number_r",
+	[SIM_STAT_GET_SUBSCRIBER_NUMBER_ASYNC] = "sim_get_subscriber_number_async",
+	[SIM_STAT_GET_MSISDN_LIST] = "sim_get_msisdn_list",
+	[SIM_STAT_MSISDN_LIST_GET_COUNT] = "sim_msisdn_list_get_count",
+	[SIM_STAT_MSISDN_LIST_GET_AT] = "sim_msisdn_list_get_at",
+	[SIM_STAT_MSISDN_LIST_DESTROY] = "sim_msisdn_list_destroy",
+	[SIM_STAT_GET_SNAPSHOT] = "sim_get_snapshot",
+	[SIM_STAT_RELEASE_SNAPSHOT] = "sim_release_snapshot",
+	[SIM_STAT_SET_STATE_CHANGED_CB] = "sim_set_state_changed_cb",
+	[SIM_STAT_UNSET_STATE_CHANGED_CB] = "sim_unset_state_changed_cb",
+	[SIM_STAT_ADD_STATE_CHANGED_CB] = "sim_add_state_changed_cb",
+	[SIM_STAT_REMOVE_STATE_CHANGED_CB] = "sim_remove_state_changed_cb",
+	[SIM_STAT_SET_STATE_CHANGED_DEBOUNCE_TIME] = "sim_set_state_changed_debounce_time",
+	[SIM_STAT_GET_ICC_ID_TIMED] = "sim_get_icc_id_timed",
+	[SIM_STAT_GET_IMSI_INFO_TIMED] = "sim_get_imsi_info_timed",
+	[SIM_STAT_GET_SPN_TIMED] = "sim_get_spn_timed",
+	[SIM_STAT_GET_CPHS_OPERATOR_NAME_TIMED] = "sim_get_cphs_operator_name_timed",
+	[SIM_STAT_GET_STATE_TIMED] = "sim_get_state_timed",
+	[SIM_STAT_GET_SUBSCRIBER_NUMBER_TIMED] = "sim_get_subscriber_number_timed",
+	[SIM_STAT_GET_SNAPSHOT_TIMED] = "sim_get_snapshot_timed",
+	[SIM_STAT_SET_TIMEOUT] = "sim_set_timeout",
+	[SIM_STAT_GET_TIMEOUT] = "sim_get_timeout",
+	[SIM_STAT_CANCELLABLE_CREATE] = "sim_cancellable_create",
+	[SIM_STAT_CANCELLABLE_CANCEL] = "sim_cancellable_cancel",
+	[SIM_STAT_CANCELLABLE_RESET] = "sim_cancellable_reset",
+	[SIM_STAT_CANCELLABLE_DESTROY] = "sim_cancellable_destroy",
+	[SIM_STAT_GET_SLOT_COUNT] = "sim_get_slot_count",
+	[SIM_STAT_SLOT_GET_ICC_ID] = "sim_slot_get_icc_id",
+	[SIM_STAT_SLOT_GET_IMSI_INFO] = "sim_slot_get_imsi_info",
+	[SIM_STAT_SLOT_GET_SPN] = "sim_slot_get_spn",
+	[SIM_STAT_SLOT_GET_CPHS_OPERATOR_NAME] = "sim_slot_get_cphs_operator_name",
+	[SIM_STAT_SLOT_GET_STATE] = "sim_slot_get_state",
+	[SIM_STAT_SLOT_GET_SUBSCRIBER_NUMBER] = "sim_slot_get_subscriber_number",
+	[SIM_STAT_SLOT_GET_SNAPSHOT] = "sim_slot_get_snapshot",
+	[SIM_STAT_SLOT_ADD_STATE_CHANGED_CB] = "sim_slot_add_state_changed_cb",
+	[SIM_STAT_GET_ALL_SNAPSHOTS] = "sim_get_all_snapshots",
+	[SIM_STAT_ENABLE_PREFETCH] = "sim_enable_prefetch",
+	[SIM_STAT_DISABLE_PREFETCH] = "sim_disable_prefetch",
+	[SIM_STAT_SET_IDENTITY_CACHE_FILE] = "sim_set_identity_cache_file",
+	[SIM_STAT_GET_LAST_KNOWN_SNAPSHOT] = "sim_get_last_known_snapshot",
+	[SIM_STAT_SET_OPTIMISTIC_MODE] = "sim_set_optimistic_mode",
+	[SIM_STAT_READ_FILES] = "sim_read_files",
+	[SIM_STAT_SLOT_READ_FILES] = "sim_slot_read_files",
+	[SIM_STAT_READ_FILES_TIMED] = "sim_read_files_timed",
+	[SIM_STAT_LOOKUP_OPERATOR] = "sim_lookup_operator",
+	[SIM_STAT_GET_HOME_OPERATOR_INFO] = "sim_get_home_operator_info",
+	[SIM_STAT_GET_EVENT_FD] = "sim_get_event_fd",
+	[SIM_STAT_READ_EVENTS] = "sim_read_events",
+	[SIM_STAT_SET_DISPATCH_MODE] = "sim_set_dispatch_mode",
+	[SIM_STAT_TEL_INIT] = "tel_init",
+	[SIM_STAT_TEL_DEINIT] = "tel_deinit",
+	[SIM_STAT_TEL_REGISTER_NOTI_EVENT] = "tel_register_noti_event",
+	[SIM_STAT_TEL_DEREGISTER_NOTI_EVENT] = "tel_deregister_noti_event",
+	[SIM_STAT_TEL_GET_CP_NAME_LIST] = "tel_get_cp_name_list",
+	[SIM_STAT_DBUS_GET_ICCID] = "dbus:GetICCID",
+	[SIM_STAT_DBUS_GET_IMSI] = "dbus:GetIMSI",
+	[SIM_STAT_DBUS_GET_SPN] = "dbus:GetSpn",
+	[SIM_STAT_DBUS_GET_CPHS_NET_NAME] = "dbus:GetCphsNetName",
+	[SIM_STAT_DBUS_GET_MSISDN] = "dbus:GetMSISDN",
+	[SIM_STAT_DBUS_GET_INIT_STATUS] = "dbus:GetInitStatus",
+	[SIM_STAT_DISPATCH_STATUS] = "dispatch:Status",
+};
+
+/* Every sim_error_e the library returns, to count failures by code */
+static const sim_error_e sim_stat_errors[] = {
+	SIM_ERROR_OUT_OF_MEMORY,
+	SIM_ERROR_INVALID_PARAMETER,
+	SIM_ERROR_OPERATION_FAILED,
+	SIM_ERROR_NOT_AVAILABLE,
+	SIM_ERROR_TRUNCATED,
+	SIM_ERROR_TIMED_OUT,
+	SIM_ERROR_CANCELED,
+};
+
+#define SIM_STAT_ERROR_MAX	(sizeof(sim_stat_errors) / sizeof(sim_stat_errors[0]))
+
+typedef struct
+{
+	unsigned long long calls;
+	unsigned long long errors;
+	unsigned long long total_ns;
+	unsigned long long histogram[SIM_STATS_HISTOGRAM_BUCKETS];
+} sim_stat_counter;
+
+static sim_stat_counter counters[SIM_STAT_MAX];
+static unsigned long long error_counts[SIM_STAT_ERROR_MAX];
+
+#define SIM_STAT_ADD(var, n)	__atomic_fetch_add(&(var), (n), __ATOMIC_RELAXED)
+#define SIM_STAT_LOAD(var)	__atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define SIM_STAT_CLEAR(var)	__atomic_store_n(&(var), 0, __ATOMIC_RELAXED)
+
+unsigned long long _sim_stats_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int _sim_stats_bucket(unsigned long long ns)
+{
+	int bucket = 63 - __builtin_clzll(ns | 1);
+
+	return bucket < SIM_STATS_HISTOGRAM_BUCKETS ? bucket : SIM_STATS_HISTOGRAM_BUCKETS - 1;
+}
+
+void _sim_stats_record(sim_stat_e stat, unsigned long long begin, int error)
+{
+	sim_stat_counter *counter = &counters[stat];
+	unsigned long long elapsed = _sim_stats_now() - begin;
+	unsigned int i = 0;
+
+	SIM_STAT_ADD(counter->calls, 1);
+	SIM_STAT_ADD(counter->total_ns, elapsed);
+	SIM_STAT_ADD(counter->histogram[_sim_stats_bucket(elapsed)], 1);
+	if (error == SIM_ERROR_NONE)
+		return;
+
+	SIM_STAT_ADD(counter->errors, 1);
+	if (stat >= SIM_STAT_API_MAX)
+		return;
+	for (i = 0; i < SIM_STAT_ERROR_MAX; i++) {
+		if (sim_stat_errors[i] == error) {
+			SIM_STAT_ADD(error_counts[i], 1);
+			break;
+		}
+	}
+}
+
+#endif
+
+int sim_get_stats(sim_stats_s *stats)
+{
+#ifdef SIM_ENABLE_STATS
+	unsigned int i = 0;
+	int j = 0;
+
+	if (stats == NULL) {
+		LOGE("[%s] INVALID_PARAMETER(0x%08x)", __FUNCTION__, SIM_ERROR_INVALID_PARAMETER);
+		return SIM_ERROR_INVALID_PARAMETER;
+	}
+
+	memset(stats, 0, sizeof(sim_stats_s));
+	stats->entries = (sim_stats_entry_s*) calloc(sizeof(sim_stats_entry_s), SIM_STAT_MAX);
+	stats->errors = (sim_stats_error_s*) calloc(sizeof(sim_stats_error_s), SIM_STAT_ERROR_MAX);
+	if (stats->entries == NULL || stats->errors == NULL) {
+		sim_release_stats(stats);
+		LOGE("[%s] OUT_OF_MEMORY(0x%08x)", __FUNCTION__, SIM_ERROR_OUT_OF_MEMORY);
+		return SIM_ERROR_OUT_OF_MEMORY;
+	}
+
+	stats->entry_count = SIM_STAT_MAX;
+	for (i = 0; i < SIM_STAT_MAX; i++) {
+		stats->entries[i].name = sim_stat_name[i];
+		stats->entries[i].calls = SIM_STAT_LOAD(counters[i].calls);
+		stats->entries[i].errors = SIM_STAT_LOAD(counters[i].errors);
+		stats->entries[i].total_ns = SIM_STAT_LOAD(counters[i].total_ns);
+		for (j = 0; j < SIM_STATS_HISTOGRAM_BUCKETS; j++)
+			stats->entries[i].histogram[j] = SIM_STAT_LOAD(counters[i].histogram[j]);
+	}
+
+	stats->error_count = SIM_STAT_ERROR_MAX;
+	for (i = 0; i < SIM_STAT_ERROR_MAX; i++) {
+		stats->errors[i].error = sim_stat_errors[i];
+		stats->errors[i].count = SIM_STAT_LOAD(error_counts[i]);
+	}
+	return SIM_ERROR_NONE;
+#else
+	LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
+	return SIM_ERROR_NOT_AVAILABLE;
+#endif
+}
+
+void sim_release_stats(sim_stats_s *stats)
+{
+	if (stats == NULL)
+		return;
+	free(stats->entries);
+	free(stats->errors);
+	memset(stats, 0, sizeof(sim_stats_s));
+}
+
+int sim_reset_stats(void)
+{
+#ifdef SIM_ENABLE_STATS
+	unsigned int i = 0;
+	int j = 0;
+
+	for (i = 0; i < SIM_STAT_MAX; i++) {
+		SIM_STAT_CLEAR(counters[i].calls);
+		SIM_STAT_CLEAR(counters[i].errors);
+		SIM_STAT_CLEAR(counters[i].total_ns);
+		for (j = 0; j < SIM_STATS_HISTOGRAM_BUCKETS; j++)
+			SIM_STAT_CLEAR(counters[i].histogram[j]);
+	}
+	for (i = 0; i < SIM_STAT_ERROR_MAX; i++)
+		SIM_STAT_CLEAR(error_counts[i]);
+	return SIM_ERROR_NONE;
+#else
+	LOGE("[%s] NOT_AVAILABLE(0x%08x)", __FUNCTION__, SIM_ERROR_NOT_AVAILABLE);
+	return SIM_ERROR_NOT_AVAILABLE;
+#endif
+}
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the License);
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an AS IS BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates sim_operator_table.h from data/mcc-mnc.csv.
+
+Both the MCC -> country and the MCC/MNC -> operator tables are perfect
+hashed with hash and displace: keys are spread over buckets by a first
+hash, then every bucket, biggest first, gets the smallest displacement
+which sends all its keys to free slots. A lookup is two hashes and one key
+compare, see src/sim_operator.c, whose _sim_operator_hash() and key
+encoding must stay in sync with hash() and the keys below.
+
+    gen-operator-table.py data/mcc-mnc.csv sim_operator_table.h
+"""
+
+import sys
+
+MASK = 0xffffffff
+
+
+def hash(key, seed):
+    h = (key + seed * 0x9e3779b9) & MASK
+    h ^= h >> 16
+    h = (h * 0x7feb352d) & MASK
+    h ^= h >> 15
+    h = (h * 0x846ca68b) & MASK
+    h ^= h >> 16
+    return h
+
+
+def country_key(mcc):
+    return int(mcc)
+
+
+def operator_key(mcc, mnc):
+    return int(mcc) * 10000 + (1000 if len(mnc) == 3 else 0) + int(mnc)
+
+
+def try_build(keys, size, bucket_count):
+    buckets = [[] for _ in range(bucket_count)]
+    for key in keys:
+        buckets[hash(key, 0) & (bucket_count - 1)].append(key)
+
+    slots = [None] * size
+    displacements = [0] * bucket_count
+    for b in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for d in range(1, 0x10000):
+            wanted = [hash(key, d) & (size - 1) for key in buckets[b]]
+            if len(set(wanted)) == len(wanted) and all(slots[s] is None for s in wanted):
+                for key, s in zip(buckets[b], wanted):
+                    slots[s] = key
+                displacements[b] = d
+                break
+        else:
+            return None
+    return displacements, slots
+
+
+def perfect_hash(keys):
+    size = 1
+    while size < len(keys):
+        size <<= 1
+    while True:
+        built = try_build(keys, size, max(1, size // 4))
+        if built is not None:
+            return built
+        size <<= 1
+
+
+def c_string(s):
+    out = ''
+    for byte in s.encode('utf-8'):
+        c = chr(byte)
+        if c in '"\\' or byte < 0x20 or byte > 0x7e:
+            out += '\\%03o' % byte
+        else:
+            out += c
+    return '"' + out + '"'
+
+
+def parse(path):
+    countries = {}
+    operators = {}
+    with open(path, encoding='utf-8') as f:
+        for number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            fields = line.split(',', 3)
+            if len(fields) != 4:
+                sys.exit('%s:%d: expected mcc,mnc,country,name' % (path, number))
+            mcc, mnc, country, name = fields
+            if len(mcc) != 3 or not mcc.isdigit() or len(country) != 2 or not country.isalpha():
+                sys.exit('%s:%d: invalid mcc or country' % (path, number))
+            if countries.setdefault(country_key(mcc), country.upper()) != country.upper():
+                sys.exit('%s:%d: MCC %s is already in another country' % (path, number, mcc))
+            if not mnc:
+                continue
+            if len(mnc) not in (2, 3) or not mnc.isdigit() or not name:
+                sys.exit('%s:%d: invalid mnc or name' % (path, number))
+            if operators.setdefault(operator_key(mcc, mnc), name) != name:
+                sys.exit('%s:%d: %s-%s is listed twice' % (path, number, mcc, mnc))
+    return countries, operators
+
+
+def write_table(out, prefix, entries, entry):
+    displacements, slots = perfect_hash(sorted(entries))
+    out.write('#define %s_BUCKETS %d\n' % (prefix.upper(), len(displacements)))
+    out.write('#define %s_SLOTS %d\n\n' % (prefix.upper(), len(slots)))
+    out.write('static const unsigned short %s_displacements[%s_BUCKETS] = {\n' % (prefix, prefix.upper()))
+    for i in range(0, len(displacements), 8):
+        out.write('\t' + ' '.join('%d,' % d for d in displacements[i:i + 8]) + '\n')
+    out.write('};\n\n')
+    out.write('static const %s_entry %s_slots[%s_SLOTS] = {\n' % (prefix, prefix, prefix.upper()))
+    for key in slots:
+        out.write('\t%s,\n' % ('{ 0, }' if key is None else entry(key)))
+    out.write('};\n\n')
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit('usage: %s MCC-MNC.CSV OUTPUT.H' % sys.argv[0])
+    countries, operators = parse(sys.argv[1])
+
+    with open(sys.argv[2], 'w', encoding='utf-8') as out:
+        out.write('/* Generated by tools/gen-operator-table.py from data/mcc-mnc.csv, do not edit. */\n\n')
+        write_table(out, 'sim_country', countries,
+                lambda key: '{ %d, %s }' % (key, c_string(countries[key])))
+        write_table(out, 'sim_operator', operators,
+                lambda key: '{ %d, %s, %s }' % (key, c_string(countries[key // 10000]),
+                    c_string(operators[key])))
+
+
+if __name__ == '__main__':
+    main()